@@ -0,0 +1,114 @@
+#include "ComputeActiveParticleCompaction.h"
+
+#include "glload/include/glload/gl_4_4.h"
+#include "ShaderStorage.h"
+#include "UintSsbo.h"
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Finds the uniforms for the "active particle compaction" compute shader and gives them 
+    initial values.
+    Generates the active list and its dispatch command.
+
+    Note: The particle buffer MUST be configured for this shader before the first call to 
+    CompactActiveParticles().
+Parameters:
+    maxParticles        Tells how many work groups to dispatch and how big the list can get.
+    computeShaderKey    Used to look up the shader's uniforms and program ID.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeActiveParticleCompaction::ComputeActiveParticleCompaction(
+    unsigned int maxParticles,
+    const std::string &computeShaderKey) :
+    _computeProgramId(0),
+    _totalParticles(0),
+    _pDispatchBuffer(0),
+    _pActiveParticleIndexBuffer(0)
+{
+    _totalParticles = maxParticles;
+
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+    _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxParticles"), maxParticles);
+    glUseProgram(0);
+
+    _pDispatchBuffer = new UintSsbo(4);
+    _pDispatchBuffer->ConfigureCompute(_computeProgramId, "ActiveParticleDispatchBuffer");
+
+    _pActiveParticleIndexBuffer = new UintSsbo(maxParticles);
+    _pActiveParticleIndexBuffer->ConfigureCompute(_computeProgramId, "ActiveParticleIndexBuffer");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up the buffers that this class owns.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeActiveParticleCompaction::~ComputeActiveParticleCompaction()
+{
+    delete _pDispatchBuffer;
+    delete _pActiveParticleIndexBuffer;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Resets the dispatch command to "no work groups" and the count to 0, and then dispatches 
+    the shader over every particle to build the list.  The barrier covers both the shaders 
+    that read the list and the indirect dispatches that read the command.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeActiveParticleCompaction::CompactActiveParticles()
+{
+    // Y and Z stay at 1; X grows as the list fills up
+    GLuint emptyDispatch[4] = { 0, 1, 1, 0 };
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pDispatchBuffer->BufferId());
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(emptyDispatch), emptyDispatch);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    GLuint numWorkGroupsX = (_totalParticles / 256) + 1;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_computeProgramId);
+    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Links the list and the dispatch command up with a compute shader that wants to be 
+    dispatched over the active particles.  The shader MUST include activeParticleList.glsl.
+Parameters:
+    computeProgramId    Self-explanatory.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeActiveParticleCompaction::ShareActiveParticleList(unsigned int computeProgramId) const
+{
+    _pDispatchBuffer->ConfigureCompute(computeProgramId, "ActiveParticleDispatchBuffer");
+    _pActiveParticleIndexBuffer->ConfigureCompute(computeProgramId, "ActiveParticleIndexBuffer");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Dispatches the compute program that is currently in use with enough work groups for the 
+    active list, as of the last call to CompactActiveParticles().  The work group count is 
+    read straight out of the buffer on the GPU.
+
+    Note: The shader MUST have 256 invocations per work group (see 
+    activeParticleCompaction.comp).
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeActiveParticleCompaction::DispatchOverActiveParticles() const
+{
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, _pDispatchBuffer->BufferId());
+    glDispatchComputeIndirect(0);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+
+class UintSsbo;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Controls the "active particle compaction" compute shader, which writes the indices of the 
+    active particles into a dense list and fills out an indirect dispatch command that covers 
+    just that list.
+
+    Every particle shader is dispatched over MAX_PARTICLE_COUNT and has each invocation return 
+    right away if its particle is inactive.  When only a few thousand particles are active, 
+    most of the work groups are launched for nothing.  With the list, the update, populate, 
+    and collision shaders are dispatched with glDispatchComputeIndirect(...) over only the 
+    active particles (see their SetActiveParticleList(...)), and the work group count never 
+    has to come back to the CPU.
+
+    The list MUST be rebuilt whenever particles become active or are moved around in the 
+    particle buffer (after the reset and after the particle reorder).  Particles that go 
+    inactive in between just get skipped, same as before.
+
+    This class owns the list and the dispatch command.
+-----------------------------------------------------------------------------------------------*/
+class ComputeActiveParticleCompaction
+{
+public:
+    ComputeActiveParticleCompaction(
+        unsigned int maxParticles, 
+        const std::string &computeShaderKey);
+    ~ComputeActiveParticleCompaction();
+
+    void CompactActiveParticles();
+    void ShareActiveParticleList(unsigned int computeProgramId) const;
+    void DispatchOverActiveParticles() const;
+
+private:
+    unsigned int _computeProgramId;
+    unsigned int _totalParticles;
+
+    // X, Y, and Z work group counts, and then the number of active particles
+    UintSsbo *_pDispatchBuffer;
+
+    // the indices of the active particles
+    UintSsbo *_pActiveParticleIndexBuffer;
+};
@@ -0,0 +1,132 @@
+#include "ComputeCellListBuild.h"
+
+#include "glload/include/glload/gl_4_4.h"
+#include "glm/gtc/type_ptr.hpp"
+#include "ShaderStorage.h"
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Finds the uniforms for the "count", "scan", and "scatter" compute shaders and gives them 
+    their values.  All of them are constant throughout the program.
+Parameters:
+    cellBufferId            The cells' SSBO.  It is cleared at the start of every build.
+    numCells                Tells the "scan" shader how many cells there are.
+    maxParticles            Tells the "count" and "scatter" shaders how big the "particle" 
+                            buffer is.
+    particleRegionRadius    Used when a particle is calculating its containing cell.
+    particleRegionCenter    Ditto
+    numColumnsInTreeInitial Ditto
+    numRowsInTreeInitial    Ditto
+    countComputeShaderKey   Used to look up the "count" shader's uniforms and program ID.
+    scanComputeShaderKey    Same, but for the "scan" shader.
+    scatterComputeShaderKey Same, but for the "scatter" shader.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeCellListBuild::ComputeCellListBuild(
+    unsigned int cellBufferId,
+    unsigned int numCells,
+    unsigned int maxParticles,
+    float particleRegionRadius,
+    const glm::vec4 &particleRegionCenter,
+    unsigned int numColumnsInTreeInitial,
+    unsigned int numRowsInTreeInitial,
+    const std::string &countComputeShaderKey,
+    const std::string &scanComputeShaderKey,
+    const std::string &scatterComputeShaderKey) :
+    _countProgramId(0),
+    _scanProgramId(0),
+    _scatterProgramId(0),
+    _cellBufferId(0),
+    _totalParticles(0),
+    _totalCells(0)
+{
+    _cellBufferId = cellBufferId;
+    _totalParticles = maxParticles;
+    _totalCells = numCells;
+
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+
+    _countProgramId = shaderStorageRef.GetShaderProgram(countComputeShaderKey);
+    _scanProgramId = shaderStorageRef.GetShaderProgram(scanComputeShaderKey);
+    _scatterProgramId = shaderStorageRef.GetShaderProgram(scatterComputeShaderKey);
+
+    // "count" uniforms
+    // Note: Same cell calculation as the "populate" shader (see ComputeQuadTreePopulate).
+    float xIncrementPerColumn = 2.0f * particleRegionRadius / numColumnsInTreeInitial;
+    float yIncrementPerRow = 2.0f * particleRegionRadius / numRowsInTreeInitial;
+    float inverseXIncrementPerColumn = 1.0f / xIncrementPerColumn;
+    float inverseYIncrementPerRow = 1.0f / yIncrementPerRow;
+
+    glUseProgram(_countProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(countComputeShaderKey, "uMaxParticles"), maxParticles);
+    glUniform1f(shaderStorageRef.GetUniformLocation(countComputeShaderKey, "uParticleRegionRadius"), particleRegionRadius);
+    glUniform4fv(shaderStorageRef.GetUniformLocation(countComputeShaderKey, "uParticleRegionCenter"), 1, glm::value_ptr(particleRegionCenter));
+    glUniform1ui(shaderStorageRef.GetUniformLocation(countComputeShaderKey, "uNumColumnsInTreeInitial"), numColumnsInTreeInitial);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(countComputeShaderKey, "uNumRowsInTreeInitial"), numRowsInTreeInitial);
+    glUniform1f(shaderStorageRef.GetUniformLocation(countComputeShaderKey, "uInverseXIncrementPerColumn"), inverseXIncrementPerColumn);
+    glUniform1f(shaderStorageRef.GetUniformLocation(countComputeShaderKey, "uInverseYIncrementPerRow"), inverseYIncrementPerRow);
+
+    // "scan" uniforms
+    glUseProgram(_scanProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(scanComputeShaderKey, "uNumCells"), numCells);
+
+    // "scatter" uniforms
+    glUseProgram(_scatterProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(scatterComputeShaderKey, "uMaxParticles"), maxParticles);
+
+    // cleanup
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Clears the cells and then runs the "count", "scan", and "scatter" passes.
+
+    MUST be called after the particles are updated for this frame and before the collisions.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeCellListBuild::BuildCellList()
+{
+    // zero every cell's offset and count without sending anything from the CPU
+    // Note: The cells are nothing but unsigned integers, so clearing the buffer as a bunch of 
+    // single-channel 32bit unsigned integers clears every member of every cell.
+    GLuint zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _cellBufferId);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    GLuint numWorkGroupsXParticles = (_totalParticles / 256) + 1;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_countProgramId);
+    glDispatchCompute(numWorkGroupsXParticles, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    // the scan walks through all the cells in a single work group (see cellListScan.comp)
+    glUseProgram(_scanProgramId);
+    glDispatchCompute(1, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    glUseProgram(_scatterProgramId);
+    glDispatchCompute(numWorkGroupsXParticles, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of cells.  Used during drawing.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeCellListBuild::NumCells() const
+{
+    return _totalCells;
+}
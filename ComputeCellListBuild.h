@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include "glm/vec4.hpp"
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Controls the compute shaders that build the "cell list" version of the quad tree.  
+
+    The node version of the quad tree gives every node a fixed-size array of particle indices.  
+    Most of those arrays are mostly empty, all of them are wiped every frame, and a node that 
+    fills up has to be subdivided.  The cell list instead sorts the particle indices by cell 
+    into a single dense array (a counting sort), and each cell only stores where its particles 
+    start in that array and how many there are.  There is no cap on the number of particles in 
+    a cell, and the collision shader reads each cell's particle indices from one contiguous 
+    chunk of memory.
+
+    It takes three passes, each of which finishes before the next one starts:
+    (1) "count": One invocation per particle.  The particle figures out which cell it is in, 
+    records it in the particle, and increments that cell's count.
+    (2) "scan": One work group for all the cells.  An exclusive prefix sum over the counts 
+    gives each cell its starting offset in the sorted array.  The counts are set back to 0.
+    (3) "scatter": One invocation per particle.  The particle increments its cell's count 
+    again, which hands out a unique slot in that cell's chunk of the sorted array, and writes 
+    its index there.  When this pass is done, the counts are back to what they were after the 
+    first pass.
+
+    The cells are cleared on the GPU at the start of each build, so nothing is uploaded from 
+    the CPU each frame.
+-----------------------------------------------------------------------------------------------*/
+class ComputeCellListBuild
+{
+public:
+    ComputeCellListBuild(
+        unsigned int cellBufferId,
+        unsigned int numCells,
+        unsigned int maxParticles,
+        float particleRegionRadius,
+        const glm::vec4 &particleRegionCenter,
+        unsigned int numColumnsInTreeInitial,
+        unsigned int numRowsInTreeInitial,
+        const std::string &countComputeShaderKey,
+        const std::string &scanComputeShaderKey,
+        const std::string &scatterComputeShaderKey);
+
+    // no destructor because this class does not own any buffers
+
+    void BuildCellList();
+    unsigned int NumCells() const;
+
+private:
+    unsigned int _countProgramId;
+    unsigned int _scanProgramId;
+    unsigned int _scatterProgramId;
+    unsigned int _cellBufferId;
+    unsigned int _totalParticles;
+    unsigned int _totalCells;
+};
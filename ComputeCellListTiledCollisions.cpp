@@ -0,0 +1,63 @@
+#include "ComputeCellListTiledCollisions.h"
+
+#include "glload/include/glload/gl_4_4.h"
+#include "ShaderStorage.h"
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Finds the uniforms for the "tiled collisions" compute shader and gives them initial values.
+Parameters:
+    numCells                One work group is dispatched for each of these.
+    numColumnsInTreeInitial Used to find a cell's neighbors.
+    numRowsInTreeInitial    Ditto
+    computeShaderKey        Used to look up the shader's uniforms and program ID.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeCellListTiledCollisions::ComputeCellListTiledCollisions(
+    unsigned int numCells,
+    unsigned int numColumnsInTreeInitial,
+    unsigned int numRowsInTreeInitial,
+    const std::string &computeShaderKey) :
+    _computeProgramId(0),
+    _totalCells(0),
+    _unifLocInverseDeltaTimeSec(-1)
+{
+    _totalCells = numCells;
+
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+    _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
+    _unifLocInverseDeltaTimeSec = shaderStorageRef.GetUniformLocation(computeShaderKey, "uInverseDeltaTimeSec");
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumCells"), numCells);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumColumnsInTreeInitial"), numColumnsInTreeInitial);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumRowsInTreeInitial"), numRowsInTreeInitial);
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Dispatches the shader, one work group per cell.  
+
+    MUST be called after ComputeCellListBuild::BuildCellList().
+Parameters:
+    deltaTimeSec    Same as the per-particle collision shader.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeCellListTiledCollisions::Update(float deltaTimeSec)
+{
+    GLuint numWorkGroupsX = _totalCells;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_computeProgramId);
+
+    // see ComputeParticleQuadTreeCollisions::Update(...) for why this is the inverse
+    glUniform1f(_unifLocInverseDeltaTimeSec, 1.0f / deltaTimeSec);
+
+    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    glUseProgram(0);
+}
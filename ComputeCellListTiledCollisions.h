@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Controls the compute shader that finds particle collisions with the "cell list" version of 
+    the quad tree one cell at a time instead of one particle at a time.  
+
+    There is one work group per cell.  The work group copies the particles in the cell and the 
+    8 cells around it into shared memory, one tile at a time, and then runs the cell's 
+    particles against the tile out of shared memory.  The per-particle collision shader (see 
+    ComputeParticleQuadTreeCollisions) reads each neighbor out of the particle buffer once for 
+    every particle around it, which adds up quickly in the dense cells that the bar emitters 
+    make.
+
+    The result is the same as the per-particle shader's "cell list" path.
+
+    Only the cell list is supported because its cells are already contiguous chunks of sorted 
+    particle indices with a fixed set of 8 neighbors.  A quad tree leaf's neighbors are any 
+    number of nodes at any level.
+-----------------------------------------------------------------------------------------------*/
+class ComputeCellListTiledCollisions
+{
+public:
+    ComputeCellListTiledCollisions(
+        unsigned int numCells,
+        unsigned int numColumnsInTreeInitial,
+        unsigned int numRowsInTreeInitial,
+        const std::string &computeShaderKey);
+
+    // no destructor because this class does not own any buffers
+
+    void Update(float deltaTimeSec);
+
+private:
+    unsigned int _computeProgramId;
+    unsigned int _totalCells;
+
+    int _unifLocInverseDeltaTimeSec;
+};
@@ -0,0 +1,154 @@
+#include "ComputeMortonQuadTreeBuild.h"
+
+#include "glload/include/glload/gl_4_4.h"
+#include "glm/gtc/type_ptr.hpp"
+#include "ShaderStorage.h"
+#include "UintSsbo.h"
+#include "ComputeRadixSort.h"
+#include "ParticleMortonQuadTree.h"
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Finds the uniforms for the "Morton codes" and "leaves" compute shaders and gives them their 
+    values.  All of them are constant throughout the program.
+    Allocates the buffer that the "leaves" shader writes its stats to.
+Parameters:
+    maxParticles            Tells the shaders how big the "particle" and sorted buffers are.
+    particleRegionRadius    Used to turn a particle's position into a Morton code.
+    particleRegionCenter    Ditto
+    collisionLevel          The tree level whose node each particle records for the 
+                            particle reorder (see ParticleMortonQuadTree::CollisionLevel(...)).
+    radixSorter             Already set up to sort the buffers that the "Morton codes" shader 
+                            writes to.
+    mortonCodesComputeShaderKey Used to look up the "Morton codes" shader's uniforms and 
+                            program ID.
+    leavesComputeShaderKey  Same, but for the "leaves" shader.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeMortonQuadTreeBuild::ComputeMortonQuadTreeBuild(
+    unsigned int maxParticles,
+    float particleRegionRadius,
+    const glm::vec4 &particleRegionCenter,
+    unsigned int collisionLevel,
+    ComputeRadixSort *radixSorter,
+    const std::string &mortonCodesComputeShaderKey,
+    const std::string &leavesComputeShaderKey) :
+    _mortonCodesProgramId(0),
+    _leavesProgramId(0),
+    _totalParticles(0),
+    _numLeaves(0),
+    _deepestLevel(0),
+    _pRadixSorter(0),
+    _pStatsBuffer(0)
+{
+    _totalParticles = maxParticles;
+    _pRadixSorter = radixSorter;
+
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+
+    _mortonCodesProgramId = shaderStorageRef.GetShaderProgram(mortonCodesComputeShaderKey);
+    _leavesProgramId = shaderStorageRef.GetShaderProgram(leavesComputeShaderKey);
+
+    // "Morton codes" uniforms
+    float inverseParticleRegionWidth = 1.0f / (2.0f * particleRegionRadius);
+    glUseProgram(_mortonCodesProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(mortonCodesComputeShaderKey, "uMaxParticles"), maxParticles);
+    glUniform1f(shaderStorageRef.GetUniformLocation(mortonCodesComputeShaderKey, "uParticleRegionRadius"), particleRegionRadius);
+    glUniform4fv(shaderStorageRef.GetUniformLocation(mortonCodesComputeShaderKey, "uParticleRegionCenter"), 1, glm::value_ptr(particleRegionCenter));
+    glUniform1f(shaderStorageRef.GetUniformLocation(mortonCodesComputeShaderKey, "uInverseParticleRegionWidth"), inverseParticleRegionWidth);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(mortonCodesComputeShaderKey, "uMortonCollisionLevel"), collisionLevel);
+
+    // "leaves" uniforms
+    glUseProgram(_leavesProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(leavesComputeShaderKey, "uNumSortedItems"), maxParticles);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(leavesComputeShaderKey, "uMaxLevel"), ParticleMortonQuadTree::_MAX_LEVELS);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(leavesComputeShaderKey, "uMaxParticlesPerLeaf"), ParticleMortonQuadTree::_MAX_PARTICLES_PER_LEAF);
+
+    // cleanup
+    glUseProgram(0);
+
+    _pStatsBuffer = new UintSsbo(2);
+    _pStatsBuffer->ConfigureCompute(_leavesProgramId, "MortonQuadTreeStatsBuffer");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Deletes the stats buffer.  The radix sorter was given to this class and is left alone.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeMortonQuadTreeBuild::~ComputeMortonQuadTreeBuild()
+{
+    delete _pStatsBuffer;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Writes the Morton codes, sorts them, and finds the leaves.  Then reads back the number of 
+    leaves and the deepest leaf level.
+
+    MUST be called after the particles are updated for this frame and before the collisions.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeMortonQuadTreeBuild::BuildTree()
+{
+    GLuint numWorkGroupsX = (_totalParticles / 256) + 1;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_mortonCodesProgramId);
+    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    glUseProgram(0);
+
+    _pRadixSorter->SortKeysAndValues();
+
+    // the leaf count doubles as the leaf allocator, so it must start at 0
+    GLuint zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pStatsBuffer->BufferId());
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    glUseProgram(_leavesProgramId);
+    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    glUseProgram(0);
+
+    // retrieve the stats (printed to screen)
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pStatsBuffer->BufferId());
+    void *bufferPtr = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, 2 * sizeof(GLuint), GL_MAP_READ_BIT);
+    unsigned int *statsPtr = static_cast<unsigned int *>(bufferPtr);
+    _numLeaves = statsPtr[0];
+    _deepestLevel = statsPtr[1];
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of leaves that were found in the last call to BuildTree().
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeMortonQuadTreeBuild::NumLeaves() const
+{
+    return _numLeaves;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the level of the deepest leaf that was found in the last call to 
+    BuildTree().
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeMortonQuadTreeBuild::DeepestLevel() const
+{
+    return _deepestLevel;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include "glm/vec4.hpp"
+
+class UintSsbo;
+class ComputeRadixSort;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Controls the compute shaders that build the Morton-ordered ("linear") quad tree (see 
+    ParticleMortonQuadTree for how the tree falls out of the sorted codes).
+
+    It takes three steps:
+    (1) "Morton codes": One invocation per particle.  Each particle writes its Morton code and 
+    its own index into the key and value buffers of the radix sort.  Inactive particles get a 
+    code that sorts to the end.
+    (2) The radix sort (see ComputeRadixSort).
+    (3) "leaves": One invocation per sorted particle.  Each one walks down the levels of the 
+    tree from the root, finding the size of the node that it is in at each level with a 
+    binary search through the sorted codes, until the node is small enough to be a leaf.  The 
+    first particle in each leaf writes the leaf out, in that particle's slot, and the 
+    collision shader walks down to the leaves from there.
+
+    Unlike ComputeQuadTreeReset, nothing is done per node every frame, and unlike the "cell 
+    list", the depth of the tree isn't fixed.  The number of leaves and the deepest leaf are 
+    read back after each build so that they can be printed to the screen.
+-----------------------------------------------------------------------------------------------*/
+class ComputeMortonQuadTreeBuild
+{
+public:
+    ComputeMortonQuadTreeBuild(
+        unsigned int maxParticles,
+        float particleRegionRadius,
+        const glm::vec4 &particleRegionCenter,
+        unsigned int collisionLevel,
+        ComputeRadixSort *radixSorter,
+        const std::string &mortonCodesComputeShaderKey,
+        const std::string &leavesComputeShaderKey);
+    ~ComputeMortonQuadTreeBuild();
+
+    void BuildTree();
+    unsigned int NumLeaves() const;
+    unsigned int DeepestLevel() const;
+
+private:
+    unsigned int _mortonCodesProgramId;
+    unsigned int _leavesProgramId;
+    unsigned int _totalParticles;
+    unsigned int _numLeaves;
+    unsigned int _deepestLevel;
+
+    // given to this class; not owned by it
+    ComputeRadixSort *_pRadixSorter;
+
+    // owned by this class
+    // Note: Two unsigned integers: the number of leaves and the deepest leaf's level.
+    UintSsbo *_pStatsBuffer;
+};
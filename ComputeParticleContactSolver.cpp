@@ -0,0 +1,213 @@
+#include "ComputeParticleContactSolver.h"
+
+#include "glload/include/glload/gl_4_4.h"
+#include "ShaderStorage.h"
+#include "UintSsbo.h"
+
+#include <string.h>    // for memcpy
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Finds the uniforms for the "contact solver" compute shader and gives them initial values.
+    Generates the position correction buffer and the stats buffer, which only this shader 
+    uses.
+
+    Note: The particle and species buffers and the collider's contact buffer (see 
+    ComputeParticleQuadTreeCollisions::ShareContactBuffer(...)) MUST be configured for this 
+    shader before the first call to Solve(...).
+Parameters:
+    maxParticles        Tells how many work groups to dispatch for the "apply" pass.
+    maxContacts         How many contacts the contact buffer can hold.
+    numIterations       How many times to solve and apply per call to Solve(...).
+    computeShaderKey    Used to look up the shader's uniforms and program ID.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeParticleContactSolver::ComputeParticleContactSolver(
+    unsigned int maxParticles,
+    unsigned int maxContacts,
+    unsigned int numIterations,
+    const std::string &computeShaderKey) :
+    _computeProgramId(0),
+    _totalParticles(0),
+    _maxContacts(0),
+    _numIterations(0),
+    _unifLocIteration(-1),
+    _unifLocApplyCorrections(-1),
+    _unifLocInverseDeltaTimeSec(-1),
+    _pPositionCorrectionBuffer(0),
+    _pStatsBuffer(0)
+{
+    _totalParticles = maxParticles;
+    _maxContacts = maxContacts;
+    _numIterations = numIterations;
+    _numPenetratingContacts.resize(numIterations, 0);
+    _maxPenetration.resize(numIterations, 0.0f);
+
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+    _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
+    _unifLocIteration = shaderStorageRef.GetUniformLocation(computeShaderKey, "uIteration");
+    _unifLocApplyCorrections = shaderStorageRef.GetUniformLocation(computeShaderKey, "uApplyCorrections");
+    _unifLocInverseDeltaTimeSec = shaderStorageRef.GetUniformLocation(computeShaderKey, "uInverseDeltaTimeSec");
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxParticles"), maxParticles);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxContacts"), maxContacts);
+    glUniform1ui(_unifLocIteration, 0);
+    glUniform1ui(_unifLocApplyCorrections, 0);
+    glUseProgram(0);
+
+    // starts out as all zeros, and the "apply" pass sets each particle's corrections back to 
+    // 0 after moving it, so it never needs to be cleared on the CPU side
+    _pPositionCorrectionBuffer = new UintSsbo(3 * maxParticles);
+    _pPositionCorrectionBuffer->ConfigureCompute(_computeProgramId, "PositionCorrectionBuffer");
+
+    // the size can't be 0 even if there are no iterations
+    _pStatsBuffer = new UintSsbo((numIterations > 0) ? (2 * numIterations) : 2);
+    _pStatsBuffer->ConfigureCompute(_computeProgramId, "ContactSolverStatsBuffer");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up the buffers that this class owns.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeParticleContactSolver::~ComputeParticleContactSolver()
+{
+    delete _pPositionCorrectionBuffer;
+    delete _pStatsBuffer;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs the iterations (see the class description) and reads back the convergence metrics.
+
+    MUST be called after the collider has filled out the contact list for this frame and 
+    before the particles are updated again.
+Parameters:
+    numContacts     How many contacts the collider found this frame (see 
+                    ComputeParticleQuadTreeCollisions::NumContacts()).  Only used to size the 
+                    dispatch; the shader reads the count out of the contact buffer itself.
+    deltaTimeSec    Used to turn each particle's change in position into a change in 
+                    velocity.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleContactSolver::Solve(unsigned int numContacts, float deltaTimeSec)
+{
+    unsigned int numContactsInBuffer = (numContacts < _maxContacts) ? numContacts : _maxContacts;
+    if (numContactsInBuffer == 0 || _numIterations == 0)
+    {
+        for (unsigned int iteration = 0; iteration < _numIterations; iteration++)
+        {
+            _numPenetratingContacts[iteration] = 0;
+            _maxPenetration[iteration] = 0.0f;
+        }
+        return;
+    }
+
+    GLuint zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pStatsBuffer->BufferId());
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    GLuint numWorkGroupsXContacts = (numContactsInBuffer / 256) + 1;
+    GLuint numWorkGroupsXParticles = (_totalParticles / 256) + 1;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_computeProgramId);
+    glUniform1f(_unifLocInverseDeltaTimeSec, 1.0f / deltaTimeSec);
+    for (unsigned int iteration = 0; iteration < _numIterations; iteration++)
+    {
+        glUniform1ui(_unifLocIteration, iteration);
+        glUniform1ui(_unifLocApplyCorrections, 0);
+        glDispatchCompute(numWorkGroupsXContacts, numWorkGroupsY, numWorkGroupsZ);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        glUniform1ui(_unifLocApplyCorrections, 1);
+        glDispatchCompute(numWorkGroupsXParticles, numWorkGroupsY, numWorkGroupsZ);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    }
+    glUniform1ui(_unifLocApplyCorrections, 0);
+    glUseProgram(0);
+
+    // one read back for all the iterations
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pStatsBuffer->BufferId());
+    void *bufferPtr = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, 2 * _numIterations * sizeof(GLuint), GL_MAP_READ_BIT);
+    unsigned int *statsPtr = static_cast<unsigned int *>(bufferPtr);
+    for (unsigned int iteration = 0; iteration < _numIterations; iteration++)
+    {
+        _numPenetratingContacts[iteration] = statsPtr[(iteration * 2) + 0];
+
+        // the shader stored the float's bits
+        memcpy(&_maxPenetration[iteration], &statsPtr[(iteration * 2) + 1], sizeof(float));
+    }
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the shader's program ID, so that the buffers that this class doesn't 
+    own can be configured for it.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeParticleContactSolver::ComputeProgramId() const
+{
+    return _computeProgramId;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of iterations per call to Solve(...).
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeParticleContactSolver::NumIterations() const
+{
+    return _numIterations;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of contacts that were still overlapping at the start of 
+    the given iteration in the last call to Solve(...).  Iteration 0 is the overlap that the 
+    solver started with.
+Parameters:
+    iteration   Self-explanatory.  0 if out of range.
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeParticleContactSolver::NumPenetratingContacts(unsigned int iteration) const
+{
+    if (iteration >= _numIterations)
+    {
+        return 0;
+    }
+    return _numPenetratingContacts[iteration];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the deepest overlap between two particles at the start of the given 
+    iteration in the last call to Solve(...).
+Parameters:
+    iteration   Self-explanatory.  0 if out of range.
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+float ComputeParticleContactSolver::MaxPenetration(unsigned int iteration) const
+{
+    if (iteration >= _numIterations)
+    {
+        return 0.0f;
+    }
+    return _maxPenetration[iteration];
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+class UintSsbo;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Controls the "contact solver" compute shader, an alternative to the elastic "contact 
+    response" shader (see ComputeParticleQuadTreeCollisions) for dense piles of particles.
+
+    The elastic response only changes velocities, so particles that are packed together keep 
+    overlapping and pushing each other around unless the time step is cut.  This runs a fixed 
+    number of Jacobi iterations of position-based non-penetration constraints instead: each 
+    iteration pushes every overlapping pair in the contact list apart, and then moves each 
+    particle by the average of its pushes.  The quad tree neighborhoods are used as they are, 
+    through the collider's contact list, so pairs that only start overlapping during the 
+    iterations are not picked up until the next frame.
+
+    Jacobi iteration was picked over Gauss-Seidel because Gauss-Seidel needs the contacts 
+    split into groups that don't share a particle (graph coloring) to run in parallel, and 
+    that would be a second pass over the contact list every frame.  Jacobi converges more 
+    slowly, which the over-relaxation in the shader makes up for some.
+
+    Convergence metrics: for every iteration, the shader counts the contacts that are still 
+    overlapping and the deepest overlap.  They are read back once after the last iteration.
+
+    This class owns the position correction buffer and the stats buffer.
+-----------------------------------------------------------------------------------------------*/
+class ComputeParticleContactSolver
+{
+public:
+    ComputeParticleContactSolver(
+        unsigned int maxParticles,
+        unsigned int maxContacts,
+        unsigned int numIterations,
+        const std::string &computeShaderKey);
+    ~ComputeParticleContactSolver();
+
+    void Solve(unsigned int numContacts, float deltaTimeSec);
+
+    unsigned int ComputeProgramId() const;
+    unsigned int NumIterations() const;
+    unsigned int NumPenetratingContacts(unsigned int iteration) const;
+    float MaxPenetration(unsigned int iteration) const;
+
+private:
+    unsigned int _computeProgramId;
+    unsigned int _totalParticles;
+    unsigned int _maxContacts;
+    unsigned int _numIterations;
+
+    // per iteration, from the last call to Solve(...)
+    std::vector<unsigned int> _numPenetratingContacts;
+    std::vector<float> _maxPenetration;
+
+    int _unifLocIteration;
+    int _unifLocApplyCorrections;
+    int _unifLocInverseDeltaTimeSec;
+
+    // X, Y, and a count per particle, fixed point
+    UintSsbo *_pPositionCorrectionBuffer;
+
+    // a count and a max overlap per iteration
+    UintSsbo *_pStatsBuffer;
+};
@@ -0,0 +1,244 @@
+#include "ComputeParticleReorder.h"
+
+#include <vector>
+
+#include "glload/include/glload/gl_4_4.h"
+#include "ShaderStorage.h"
+#include "UintSsbo.h"
+#include "ParticleSsbo.h"
+#include "ComputeRadixSort.h"
+
+// given to particleReorderGather.comp as uniforms
+static const unsigned int PARTICLE_SIZE_BYTES = sizeof(Particle);
+static const unsigned int CACHE_LINE_SIZE_BYTES = 128;
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Allocates the buffers for the sort, the temporary particle buffer, the "where it went" 
+    table, and the stats, and configures them for the shaders that use them.
+    Finds the uniforms for the "keys", "gather", and "remap" compute shaders and gives them 
+    their values.  All of them are constant throughout the program.
+
+    Note: The particle buffer and the spatial structure's buffers belong to someone else, so 
+    they need to be configured for these shaders by whoever made them.
+Parameters:
+    maxParticles            Tells the shaders how big the "particle" buffer is.
+    particleBufferId        The reordered particles are copied back into this.
+    remapQuadTreeNodes      If true, the "remap" shader remaps the quad tree nodes' particle 
+                            indices.  Otherwise it remaps the sorted particle indices of the 
+                            "cell list" or the Morton quad tree.
+    numItemsToRemap         The number of quad tree nodes or sorted particle indices.
+    reorderIntervalFrames   The particles are reordered once every this many frames.  0 turns 
+                            it off.
+    keysComputeShaderKey    Used to look up the "keys" shader's uniforms and program ID.
+    gatherComputeShaderKey  Same, but for the "gather" shader.
+    remapComputeShaderKey   Same, but for the "remap" shader.
+    radixSortHistogramComputeShaderKey  Given to the radix sort.
+    radixSortScanComputeShaderKey       Ditto
+    radixSortScatterComputeShaderKey    Ditto
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeParticleReorder::ComputeParticleReorder(
+    unsigned int maxParticles,
+    unsigned int particleBufferId,
+    bool remapQuadTreeNodes,
+    unsigned int numItemsToRemap,
+    unsigned int reorderIntervalFrames,
+    const std::string &keysComputeShaderKey,
+    const std::string &gatherComputeShaderKey,
+    const std::string &remapComputeShaderKey,
+    const std::string &radixSortHistogramComputeShaderKey,
+    const std::string &radixSortScanComputeShaderKey,
+    const std::string &radixSortScatterComputeShaderKey) :
+    _keysProgramId(0),
+    _gatherProgramId(0),
+    _remapProgramId(0),
+    _totalParticles(0),
+    _particleBufferId(0),
+    _numItemsToRemap(0),
+    _reorderIntervalFrames(0),
+    _framesSinceReorder(0),
+    _bytesSavedPerWalk(0),
+    _pNodeKeysBuffer(0),
+    _pNewOrderBuffer(0),
+    _pNewParticleIndexBuffer(0),
+    _pStatsBuffer(0),
+    _pReorderedParticleBuffer(0),
+    _pRadixSorter(0)
+{
+    _totalParticles = maxParticles;
+    _particleBufferId = particleBufferId;
+    _numItemsToRemap = numItemsToRemap;
+    _reorderIntervalFrames = reorderIntervalFrames;
+
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+
+    _keysProgramId = shaderStorageRef.GetShaderProgram(keysComputeShaderKey);
+    _gatherProgramId = shaderStorageRef.GetShaderProgram(gatherComputeShaderKey);
+    _remapProgramId = shaderStorageRef.GetShaderProgram(remapComputeShaderKey);
+
+    glUseProgram(_keysProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(keysComputeShaderKey, "uMaxParticles"), maxParticles);
+
+    glUseProgram(_gatherProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(gatherComputeShaderKey, "uMaxParticles"), maxParticles);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(gatherComputeShaderKey, "uParticleSizeBytes"), PARTICLE_SIZE_BYTES);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(gatherComputeShaderKey, "uCacheLineSizeBytes"), CACHE_LINE_SIZE_BYTES);
+
+    glUseProgram(_remapProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(remapComputeShaderKey, "uMaxParticles"), maxParticles);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(remapComputeShaderKey, "uNumItemsToRemap"), numItemsToRemap);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(remapComputeShaderKey, "uRemapQuadTreeNodes"), remapQuadTreeNodes ? 1 : 0);
+
+    // cleanup
+    glUseProgram(0);
+
+    // the keys and values are sorted in place, so after the sort, the values are the new order
+    _pNodeKeysBuffer = new UintSsbo(maxParticles);
+    _pNodeKeysBuffer->ConfigureCompute(_keysProgramId, "NodeKeyBuffer");
+    _pNodeKeysBuffer->ConfigureCompute(_gatherProgramId, "NodeKeyBuffer");
+
+    _pNewOrderBuffer = new UintSsbo(maxParticles);
+    _pNewOrderBuffer->ConfigureCompute(_keysProgramId, "NewOrderBuffer");
+    _pNewOrderBuffer->ConfigureCompute(_gatherProgramId, "NewOrderBuffer");
+
+    _pNewParticleIndexBuffer = new UintSsbo(maxParticles);
+    _pNewParticleIndexBuffer->ConfigureCompute(_gatherProgramId, "NewParticleIndexBuffer");
+    _pNewParticleIndexBuffer->ConfigureCompute(_remapProgramId, "NewParticleIndexBuffer");
+
+    // Note: Two unsigned integers: cache lines before and after the move.
+    _pStatsBuffer = new UintSsbo(2);
+    _pStatsBuffer->ConfigureCompute(_gatherProgramId, "ParticleReorderStatsBuffer");
+
+    // contents don't matter because all of it is overwritten before it is used
+    std::vector<Particle> allParticles(maxParticles);
+    _pReorderedParticleBuffer = new ParticleSsbo(allParticles);
+    _pReorderedParticleBuffer->ConfigureCompute(_gatherProgramId, "ReorderedParticleBuffer");
+
+    _pRadixSorter = new ComputeRadixSort(maxParticles, _pNodeKeysBuffer, _pNewOrderBuffer, radixSortHistogramComputeShaderKey, radixSortScanComputeShaderKey, radixSortScatterComputeShaderKey);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Deletes everything that this class made.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeParticleReorder::~ComputeParticleReorder()
+{
+    delete _pRadixSorter;
+    delete _pNodeKeysBuffer;
+    delete _pNewOrderBuffer;
+    delete _pNewParticleIndexBuffer;
+    delete _pStatsBuffer;
+    delete _pReorderedParticleBuffer;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Call once per frame.  Only does anything once every "reorder interval" frames.
+
+    MUST be called after the spatial structure has been built for this frame (the particles' 
+    node indices are the sort keys, and the structure's lists of particle indices are 
+    remapped) and before the collisions.
+Parameters: None
+Returns:
+    True if the particles were moved, otherwise false.  Anything that holds particle indices 
+    and isn't remapped here (such as the active particle list) is out of date if true.
+-----------------------------------------------------------------------------------------------*/
+bool ComputeParticleReorder::ReorderParticles()
+{
+    if (_reorderIntervalFrames == 0)
+    {
+        return false;
+    }
+
+    _framesSinceReorder++;
+    if (_framesSinceReorder < _reorderIntervalFrames)
+    {
+        return false;
+    }
+    _framesSinceReorder = 0;
+
+    GLuint numWorkGroupsXParticles = (_totalParticles / 256) + 1;
+    GLuint numWorkGroupsXRemap = (_numItemsToRemap / 256) + 1;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_keysProgramId);
+    glDispatchCompute(numWorkGroupsXParticles, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    glUseProgram(0);
+
+    _pRadixSorter->SortKeysAndValues();
+
+    GLuint zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pStatsBuffer->BufferId());
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    glUseProgram(_gatherProgramId);
+    glDispatchCompute(numWorkGroupsXParticles, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    glUseProgram(0);
+
+    // replace the particles with their reordered copies
+    GLuint bufferSizeBytes = sizeof(Particle) * _totalParticles;
+    glBindBuffer(GL_COPY_READ_BUFFER, _pReorderedParticleBuffer->BufferId());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _particleBufferId);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, bufferSizeBytes);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    glUseProgram(_remapProgramId);
+    glDispatchCompute(numWorkGroupsXRemap, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    glUseProgram(0);
+
+    // retrieve the cache line counts (printed to screen)
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pStatsBuffer->BufferId());
+    void *bufferPtr = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, 2 * sizeof(GLuint), GL_MAP_READ_BIT);
+    unsigned int *statsPtr = static_cast<unsigned int *>(bufferPtr);
+    unsigned int cacheLinesBefore = statsPtr[0];
+    unsigned int cacheLinesAfter = statsPtr[1];
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    _bytesSavedPerWalk = 0;
+    if (cacheLinesBefore > cacheLinesAfter)
+    {
+        _bytesSavedPerWalk = (cacheLinesBefore - cacheLinesAfter) * CACHE_LINE_SIZE_BYTES;
+    }
+
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    An estimate of how much less memory is read by one walk through all the active particles 
+    in node order after the last reorder than before it.  Collision detection does roughly 
+    one such walk for every neighbor that it checks, every frame until the next reorder.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeParticleReorder::BytesSavedPerWalk() const
+{
+    return _bytesSavedPerWalk;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The cost side of the reorder: the particles are read once and written twice (once into the 
+    temporary buffer and once back).  The sort is on top of that, but it is small by comparison.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeParticleReorder::BytesMovedPerReorder() const
+{
+    return 3 * PARTICLE_SIZE_BYTES * _totalParticles;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <string>
+
+class UintSsbo;
+class ParticleSsbo;
+class ComputeRadixSort;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Controls the compute shaders that physically move the particles around in the particle 
+    buffer so that particles that are close to each other in space are also close to each 
+    other in memory.
+
+    Particles are spawned into whatever slot is free, so after a little while, the particles 
+    in any one node are scattered across the whole particle buffer, and the collision shader 
+    reads them from all over the place.  Every so many frames, this sorts the particles by the 
+    node (or cell, or Morton node) that they are in and moves them into that order:
+    (1) "keys": One invocation per particle.  The key is the particle's node, and the value is 
+    the particle's index.  Inactive particles sort to the end.
+    (2) The radix sort (see ComputeRadixSort).  The sorted values are now the new order: the 
+    particle that goes into slot i is the one that was in slot value[i].
+    (3) "gather": One invocation per slot.  Copies the particle into a temporary buffer in its 
+    new order and records where it went.  The temporary buffer is then copied over the 
+    particle buffer.
+    (4) "remap": The spatial structure was built this frame with the old particle indices, so 
+    its lists of particle indices are sent through the "where it went" table.  Each particle's 
+    own node index is part of the particle, so it moves with the particle and needs nothing.
+
+    The "gather" shader also counts how many cache lines it takes to read the particles in node 
+    order before and after the move.  The difference is an estimate of the memory traffic that 
+    is saved every time something walks through the particles by node (ex: the collision 
+    shader).  The further the particles drift out of order between reorders, the bigger the 
+    savings, so this can be used to pick how often to reorder.
+-----------------------------------------------------------------------------------------------*/
+class ComputeParticleReorder
+{
+public:
+    ComputeParticleReorder(
+        unsigned int maxParticles,
+        unsigned int particleBufferId,
+        bool remapQuadTreeNodes,
+        unsigned int numItemsToRemap,
+        unsigned int reorderIntervalFrames,
+        const std::string &keysComputeShaderKey,
+        const std::string &gatherComputeShaderKey,
+        const std::string &remapComputeShaderKey,
+        const std::string &radixSortHistogramComputeShaderKey,
+        const std::string &radixSortScanComputeShaderKey,
+        const std::string &radixSortScatterComputeShaderKey);
+    ~ComputeParticleReorder();
+
+    bool ReorderParticles();
+    unsigned int BytesSavedPerWalk() const;
+    unsigned int BytesMovedPerReorder() const;
+
+private:
+    unsigned int _keysProgramId;
+    unsigned int _gatherProgramId;
+    unsigned int _remapProgramId;
+    unsigned int _totalParticles;
+    unsigned int _particleBufferId;
+    unsigned int _numItemsToRemap;
+    unsigned int _reorderIntervalFrames;
+    unsigned int _framesSinceReorder;
+    unsigned int _bytesSavedPerWalk;
+
+    // all owned by this class
+    UintSsbo *_pNodeKeysBuffer;
+    UintSsbo *_pNewOrderBuffer;
+    UintSsbo *_pNewParticleIndexBuffer;
+    UintSsbo *_pStatsBuffer;
+    ParticleSsbo *_pReorderedParticleBuffer;
+    ComputeRadixSort *_pRadixSorter;
+};
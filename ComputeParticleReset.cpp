@@ -1,19 +1,24 @@
 #include "ComputeParticleReset.h"
 
 #include "ShaderStorage.h"
+#include "UintSsbo.h"
+#include "ParticleEmitterSsbo.h"
 
 #include "glload/include/glload/gl_4_4.h"
 #include "glm/gtc/type_ptr.hpp"
 
-// for starting up the atomic counter for the compute shader's rand hash
+// for the random number generator's seed
 #include <random>
 #include <time.h>
 
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Generates atomic counters for use in the "particle reset" compute shader.
     Looks up all uniforms in the compute shader.
+    Picks the seed for the shader's random numbers (see counterRandom.glsl).
+    Generates the free particle stack.  It is filled in on the first call to 
+    ResetParticles(...).
+    Generates the emitter table.  Same.
 
     Note: This constructor takes a string key for the compute shader instead of a program ID 
     because the shader storage object, which is responsible for finding uniforms, takes a shader 
@@ -25,55 +30,53 @@ Returns:    None
 Creator:    John Cox (11-24-2016)
 -----------------------------------------------------------------------------------------------*/
 ComputeParticleReset::ComputeParticleReset(unsigned int numParticles, 
-    const std::string &computeShaderKey)
+    const std::string &computeShaderKey) :
+    _randomSeed(0),
+    _frameNumber(0),
+    _unifLocRandomSeed(-1),
+    _unifLocFrameNumber(-1),
+    _pFreeParticleStack(0),
+    _haveFreeParticleStack(false),
+    _pEmitterTableBuffer(0),
+    _emitterTableIsCurrent(false),
+    _emitterTableParticlesPerEmitter(0),
+    _totalParticlesToEmit(0)
 {
     _totalParticleCount = numParticles;
     ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
     
     // find the uniforms in the "reset" compute shader
     _unifLocParticleCount = shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxParticleCount");
-    _unifLocMaxParticleEmitCount = shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxParticleEmitCount");
-    _unifLocMinParticleVelocity = shaderStorageRef.GetUniformLocation(computeShaderKey, "uMinParticleVelocity");
-    _unifLocDeltaParticleVelocity = shaderStorageRef.GetUniformLocation(computeShaderKey, "uDeltaParticleVelocity");
-    _unifLocUsePointEmitter = shaderStorageRef.GetUniformLocation(computeShaderKey, "uUsePointEmitter");
-    _unifLocPointEmitterCenter = shaderStorageRef.GetUniformLocation(computeShaderKey, "uPointEmitterCenter");
-    _unifLocBarEmitterP1 = shaderStorageRef.GetUniformLocation(computeShaderKey, "uBarEmitterP1");
-    _unifLocBarEmitterP2 = shaderStorageRef.GetUniformLocation(computeShaderKey, "uBarEmitterP2");
-    _unifLocBarEmitterEmitDir = shaderStorageRef.GetUniformLocation(computeShaderKey, "uBarEmitterEmitDir");
-
-    // now set up the atomic counters
+    _unifLocNumEmitters = shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumEmitters");
+    _unifLocTotalParticlesToEmit = shaderStorageRef.GetUniformLocation(computeShaderKey, "uTotalParticlesToEmit");
+    _unifLocRebuildFreeParticleStack = shaderStorageRef.GetUniformLocation(computeShaderKey, "uRebuildFreeParticleStack");
+    _unifLocRandomSeed = shaderStorageRef.GetUniformLocation(computeShaderKey, "uRandomSeed");
+    _unifLocFrameNumber = shaderStorageRef.GetUniformLocation(computeShaderKey, "uFrameNumber");
+
     _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
 
     glUseProgram(_computeProgramId);
 
     // the program in which this uniform is located must be bound in order to set the value
     glUniform1ui(_unifLocParticleCount, numParticles);
+    glUniform1ui(_unifLocRebuildFreeParticleStack, 0);
+    glUniform1ui(_unifLocNumEmitters, 0);
+    glUniform1ui(_unifLocTotalParticlesToEmit, 0);
 
-    // atomic counter initialization courtesy of geeks3D (and my use of glBufferData(...) 
-    // instead of glMapBuffer(...) and atomic counter arrays courtesy of lighthouse3d
-    // http://www.geeks3d.com/20120309/opengl-4-2-atomic-counter-demo-rendering-order-of-fragments/
-    // http://www.lighthouse3d.com/tutorials/opengl-atomic-counters/
-
-    // allocate space for both atomic counters, but don't bother giving them data until 
-    // ResetParticles(...)
-    glGenBuffers(1, &_atomicCounterBufferId);
-    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _atomicCounterBufferId);
-    glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(GLuint) * 2, 0, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
-
-    // both atomic counters are in the same buffer, and they are 32bit unsigned integers, so 
-    // they are 4 bytes apart
+    // the seed is the only thing that differs between runs; everything else that goes into a 
+    // random number is the particle index, the frame number, and the stream
     srand(static_cast<unsigned int>(time(nullptr)));
-    _acParticleCounterOffset = 0;
-    _acRandSeedOffset = 4;
+    _randomSeed = static_cast<unsigned int>(rand());
+    glUniform1ui(_unifLocRandomSeed, _randomSeed);
+    glUniform1ui(_unifLocFrameNumber, _frameNumber);
+    glUseProgram(0);
 
-    glUseProgram(_computeProgramId);
+    // the count, then room for every particle
+    _pFreeParticleStack = new UintSsbo(1 + numParticles);
+    _pFreeParticleStack->ConfigureCompute(_computeProgramId, "FreeParticleIndexBuffer");
 
-    // don't need to have a program or bound buffer to set the buffer base
-    // Note: It seems that atomic counters must be bound where they are declared and cannot be 
-    // bound dynamically like the ParticleSsbo and PolygonSsbo.  So remember to use the SAME buffer 
-    // binding base as specified in the shader.
-    glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 1, _atomicCounterBufferId);
+    _pEmitterTableBuffer = new ParticleEmitterSsbo(MAX_EMITTERS);
+    _pEmitterTableBuffer->ConfigureCompute(_computeProgramId, "ParticleEmitterBuffer");
 }
 
 /*-----------------------------------------------------------------------------------------------
@@ -85,14 +88,14 @@ Creator:    John Cox (11-24-2016)
 -----------------------------------------------------------------------------------------------*/
 ComputeParticleReset::~ComputeParticleReset()
 {
-    glDeleteBuffers(1, &_atomicCounterBufferId);
+    delete _pFreeParticleStack;
+    delete _pEmitterTableBuffer;
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Adds a point emitter to internal storage.  This is used to initialize particles.  If there 
-    multiple emitters, then the update will need to perform multiple calls to the compute 
-    shader, each with different emitter information.
+    Adds a point emitter to internal storage.  This is used to initialize particles.  All the 
+    emitters go into one table, and one call to the compute shader serves all of them.
 
     If, for some reason, the particle emitter cannot be cast to either a point emitter or a bar 
     emitter, then the emitter will not be added to either particle emitter collection and 
@@ -112,14 +115,21 @@ bool ComputeParticleReset::AddEmitter(const IParticleEmitter *pEmitter)
     const ParticleEmitterBar *barEmitter =
         dynamic_cast<const ParticleEmitterBar *>(pEmitter);
 
-    if (pointEmitter != 0 && (_pointEmitters.size() < MAX_EMITTERS))
+    if ((_pointEmitters.size() + _barEmitters.size()) >= MAX_EMITTERS)
+    {
+        return false;
+    }
+
+    if (pointEmitter != 0)
     {
         _pointEmitters.push_back(pointEmitter);
+        _emitterTableIsCurrent = false;
         return true;
     }
-    else if (barEmitter != 0 && (_barEmitters.size() < MAX_EMITTERS))
+    else if (barEmitter != 0)
     {
         _barEmitters.push_back(barEmitter);
+        _emitterTableIsCurrent = false;
         return true;
     }
 
@@ -128,18 +138,15 @@ bool ComputeParticleReset::AddEmitter(const IParticleEmitter *pEmitter)
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Resets the atomic counters and dispatches the shader.
+    Brings the emitter table up to date if it needs it, moves the random numbers on to the next 
+    frame, and dispatches the shader once for all the emitters.
 
-    The number of work groups is based on the maximum number of particles.
+    The number of work groups is based on the total number of particles that all the emitters 
+    emit (see the class description).
 
-    All the particle emitters reset particles to that emitter's location (up to a limit).
-
-    Particles are spread out evenly between all the emitters (or at least as best as possible; 
-    technically the first emitter emitter gets first dibs at the inactive particles, then the 
-    second emitter gets second dibs, etc.).  This caused some trouble because successive calls 
-    to the compute shader in the same frame caused many particles to have their positions 
-    updated more than once.  To solve this, the compute shader was split into two major 
-    sections: 
+    Particles are spread out evenly between all the emitters.  Each emitter gets its own range 
+    of invocations, so there is no "first dibs" for the first emitter, except that the free 
+    particle stack can run out part way through.
 Parameters:    
     particlesPerEmitterPerFrame        Limits the number of particles that are reset per frame so 
     that they don't all spawn at once.
@@ -155,90 +162,197 @@ void ComputeParticleReset::ResetParticles(unsigned int particlesPerEmitterPerFra
         return;
     }
 
-    GLuint acResetCounterValue = 0;
-    GLuint acRandSeed = rand();
+    if (!_haveFreeParticleStack)
+    {
+        RebuildFreeParticleStack();
+    }
+
+    if (!_emitterTableIsCurrent || particlesPerEmitterPerFrame != _emitterTableParticlesPerEmitter)
+    {
+        UpdateEmitterTable(particlesPerEmitterPerFrame);
+    }
+
+    if (_totalParticlesToEmit == 0)
+    {
+        return;
+    }
+
+    // one invocation per particle to emit; each one finds its emitter in the table and pops 
+    // its particle off the free stack
+    // Note: This used to be one dispatch per emitter, each of them one invocation per particle 
+    // in the buffer, and the emitters took turns walking the whole thing looking for inactive 
+    // particles.
+    GLuint numWorkGroupsX = (_totalParticlesToEmit / 256) + 1;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_computeProgramId);
+
+    // a new frame gets new random numbers (see counterRandom.glsl)
+    // Note: If it reaches maximum unsigned int, that is ok.  The value will wrap around to 0 
+    // and begin again.
+    _frameNumber++;
+    glUniform1ui(_unifLocFrameNumber, _frameNumber);
+
+    // compute ALL the resets!
+    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+
+    // tell the GPU:
+    // (1) Accesses to the shader buffer after this call will reflect writes prior to the 
+    // barrier.  This is only available in OpenGL 4.3 or higher.
+    // (2) Vertex data sourced from buffer objects after the barrier will reflect data 
+    // written by shaders prior to the barrier.  The affected buffer(s) is determined by the 
+    // buffers that were bound for the vertex attributes.  In this case, that means 
+    // GL_ARRAY_BUFFER.
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+    // cleanup
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Links the free particle stack up with another compute shader that deactivates particles 
+    (the "update" shader).  The shader MUST include freeParticleStack.glsl and push every 
+    particle that it deactivates.
+Parameters:
+    computeProgramId    Self-explanatory.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleReset::ShareFreeParticleStack(unsigned int computeProgramId) const
+{
+    _pFreeParticleStack->ConfigureCompute(computeProgramId, "FreeParticleIndexBuffer");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Empties the free particle stack and then dispatches the shader in "rebuild" mode over 
+    every particle so that each inactive particle pushes itself.  Done once before the first 
+    reset, and MUST be done again whenever the particles are moved around in the particle 
+    buffer (see ComputeParticleReorder::ReorderParticles()), because the stack holds particle 
+    indices.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleReset::RebuildFreeParticleStack()
+{
+    GLint zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pFreeParticleStack->BufferId());
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GLint), &zero);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
-    // spreading the particles evenly between multiple emitters is done by letting all the 
-    // particle emitters have a go at all the inactive particles one by one, so all particles 
-    // must be considered
-    // Note: Yes, this algorithm is such that emitters resetting particles have to traverse 
-    // through the entire particle collection, but since there isn't a way of telling the CPU 
-    // where they were when the last particle was reset and since the GPU seems pretty fast on 
-    // running through the entire array, this algorithm is fine.
     GLuint numWorkGroupsX = (_totalParticleCount / 256) + 1;
     GLuint numWorkGroupsY = 1;
     GLuint numWorkGroupsZ = 1;
 
     glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocRebuildFreeParticleStack, 1);
+    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    glUniform1ui(_unifLocRebuildFreeParticleStack, 0);
+    glUseProgram(0);
 
-    glUniform1ui(_unifLocMaxParticleEmitCount, particlesPerEmitterPerFrame);
-    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _atomicCounterBufferId);
+    _haveFreeParticleStack = true;
+}
 
-    // give the rand seed some variance from the last frame
-    glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, _acRandSeedOffset, sizeof(GLuint), &acRandSeed);
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Tells this class that an emitter that was already added has moved or changed its 
+    velocities, so the table is written again before the next reset.  The table isn't written 
+    every frame because nothing in this demo moves the emitters after they are added.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleReset::EmittersChanged()
+{
+    _emitterTableIsCurrent = false;
+}
 
-    // give all point emitters a chance to reactivate inactive particles at their positions
-    glUniform1ui(_unifLocUsePointEmitter, 1);
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Writes every emitter into the table, point emitters first and then bar emitters (the same 
+    order that they used to be dispatched in), and uploads it.  Each emitter's first 
+    invocation is the total of the emitters before it (an exclusive prefix sum), and the shader 
+    is told the grand total.
+
+    Note: The prefix sum is done here instead of on the GPU (see prefixScan.comp) because the 
+    CPU already has every emitter's count in hand and the table is only written when something 
+    changes.
+Parameters:
+    particlesPerEmitterPerFrame     How many particles each emitter emits per reset.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleReset::UpdateEmitterTable(unsigned int particlesPerEmitterPerFrame)
+{
+    _emitterTable.clear();
+    _emitterTable.reserve(_pointEmitters.size() + _barEmitters.size());
+    unsigned int firstEmitIndex = 0;
     for (size_t pointEmitterCount = 0; pointEmitterCount < _pointEmitters.size(); pointEmitterCount++)
     {
-        // reset everything necessary to control the emission parameters for this emitter
-        glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, _acParticleCounterOffset, sizeof(GLuint), (void *)&acResetCounterValue);
-
         const ParticleEmitterPoint *emitter = _pointEmitters[pointEmitterCount];
-        glUniform1f(_unifLocMinParticleVelocity, emitter->GetMinVelocity());
-        glUniform1f(_unifLocDeltaParticleVelocity, emitter->GetDeltaVelocity());
-
-        // use an array for uploading vectors to be certain of the ordering 
-        //glm::vec4 emitterPos = emitter->GetPos();
-        //float emitterPosArr[4] = { emitterPos.x, emitterPos.y, emitterPos.z, emitterPos.w };
-        //glUniform4fv(_unifLocPointEmitterCenter, 1, emitterPosArr);
-        glUniform4fv(_unifLocPointEmitterCenter, 1, glm::value_ptr(emitter->GetPos()));
-
-        // compute ALL the resets!
-        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
-
-        // tell the GPU:
-        // (1) Accesses to the shader buffer after this call will reflect writes prior to the 
-        // barrier.  This is only available in OpenGL 4.3 or higher.
-        // (2) Vertex data sourced from buffer objects after the barrier will reflect data 
-        // written by shaders prior to the barrier.  The affected buffer(s) is determined by the 
-        // buffers that were bound for the vertex attributes.  In this case, that means 
-        // GL_ARRAY_BUFFER.
-        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+        ParticleEmitterTableEntry entry;
+        entry._p1 = emitter->GetPos();
+        entry._minVelocity = emitter->GetMinVelocity();
+        entry._deltaVelocity = emitter->GetDeltaVelocity();
+        entry._isPointEmitter = 1;
+        entry._firstEmitIndex = firstEmitIndex;
+        entry._numToEmit = particlesPerEmitterPerFrame;
+        _emitterTable.push_back(entry);
+        firstEmitIndex += particlesPerEmitterPerFrame;
     }
 
-    // repeat for any bar emitters
-    glUniform1ui(_unifLocUsePointEmitter, 0);
     for (size_t barEmitterCount = 0; barEmitterCount < _barEmitters.size(); barEmitterCount++)
     {
-        glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, _acParticleCounterOffset, sizeof(GLuint), (void *)&acResetCounterValue);
-
         const ParticleEmitterBar *emitter = _barEmitters[barEmitterCount];
-        glUniform1f(_unifLocMinParticleVelocity, emitter->GetMinVelocity());
-        glUniform1f(_unifLocDeltaParticleVelocity, emitter->GetDeltaVelocity());
-
-        // each bar needs to upload three vectors (p1, p2, and emit direction)
-
-        //glm::vec4 emitterBarP1 = emitter->GetBarStart();
-        //glm::vec4 emitterBarP2 = emitter->GetBarEnd();
-        //glm::vec4 emitDir = emitter->GetEmitDir();
-        //float emitterBarP1Arr[4] = { emitterBarP1.x, emitterBarP1.y, emitterBarP1.z, emitterBarP1.w };
-        //float emitterBarP2Arr[4] = { emitterBarP2.x, emitterBarP2.y, emitterBarP2.z, emitterBarP2.w };
-        //float emitterBarEmitDir[4] = { emitDir.x, emitDir.y, emitDir.z, emitDir.w };
-        //glUniform4fv(_unifLocBarEmitterP1, 1, emitterBarP1Arr);
-        //glUniform4fv(_unifLocBarEmitterP2, 1, emitterBarP2Arr);
-        //glUniform4fv(_unifLocBarEmitterEmitDir, 1, emitterBarEmitDir);
-
-        glUniform4fv(_unifLocBarEmitterP1, 1, glm::value_ptr(emitter->GetBarStart()));
-        glUniform4fv(_unifLocBarEmitterP2, 1, glm::value_ptr(emitter->GetBarEnd()));
-        glUniform4fv(_unifLocBarEmitterEmitDir, 1, glm::value_ptr(emitter->GetEmitDir()));
-
-        // MOAR resets!
-        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
-        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+        ParticleEmitterTableEntry entry;
+        entry._p1 = emitter->GetBarStart();
+        entry._p2 = emitter->GetBarEnd();
+        entry._emitDir = emitter->GetEmitDir();
+        entry._minVelocity = emitter->GetMinVelocity();
+        entry._deltaVelocity = emitter->GetDeltaVelocity();
+        entry._isPointEmitter = 0;
+        entry._firstEmitIndex = firstEmitIndex;
+        entry._numToEmit = particlesPerEmitterPerFrame;
+        _emitterTable.push_back(entry);
+        firstEmitIndex += particlesPerEmitterPerFrame;
     }
 
-    // cleanup
-    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+    // AddEmitter(...) enforces the limit, so this fits
+    _pEmitterTableBuffer->UpdateEmitters(_emitterTable);
+    _totalParticlesToEmit = firstEmitIndex;
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocNumEmitters, _emitterTable.size());
+    glUniform1ui(_unifLocTotalParticlesToEmit, _totalParticlesToEmit);
     glUseProgram(0);
+
+    _emitterTableParticlesPerEmitter = particlesPerEmitterPerFrame;
+    _emitterTableIsCurrent = true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the seed of the shader's random numbers.  Together with the particle 
+    index, the frame number, and RANDOM_STREAM_PARTICLE_RESET, it gives NewRandomStream(...) 
+    (see RandomToast.h) the same numbers that the shader used.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeParticleReset::RandomSeed() const
+{
+    return _randomSeed;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the frame number that the last call to ResetParticles(...) gave to the 
+    shader's random numbers.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeParticleReset::FrameNumber() const
+{
+    return _frameNumber;
 }
@@ -3,9 +3,13 @@
 #include "IParticleEmitter.h"
 #include "ParticleEmitterPoint.h"
 #include "ParticleEmitterBar.h"
+#include "ParticleEmitterTableEntry.h"
 #include <string>
 #include <vector>
 
+class UintSsbo;
+class ParticleEmitterSsbo;
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     Encapsulate particle reseting via compute shader.  Resetting involves taking inactive 
@@ -18,6 +22,24 @@ Description:
 
     Note: When this class goes "poof", it won't delete the emitter pointers.  This is ensured by
     only using const pointers.
+
+    Update: The inactive particles are kept on a stack on the GPU (see freeParticleStack.glsl) 
+    instead of being searched for.  The "update" shader pushes every particle that it 
+    deactivates, and this shader pops one per emitted particle, so each emitter's dispatch is 
+    only as big as the number of particles that it emits.  This class owns the stack, and the 
+    "update" shader MUST be linked to it (see ShareFreeParticleStack(...)).
+
+    Update: The emitters are uploaded once to a table in an SSBO (see 
+    ParticleEmitterTableEntry) instead of as uniforms before each emitter's dispatch, and one 
+    dispatch emits for all of them.  Each emitter's invocations start at the total of the 
+    emitters before it.  The number of dispatches, barriers, and uniform uploads per frame no 
+    longer grows with the number of emitters.  The table is only written again when an emitter 
+    is added, when the number of particles per emitter changes, or when told to (see 
+    EmittersChanged()).
+
+    Update: The random numbers are hashed from the particle index and a frame number that this 
+    class counts (see counterRandom.glsl) instead of from atomic counters, so the numbers are 
+    the same on every run with the same seed and the CPU can make them too (see RandomToast.h).
 Creator:    John Cox (11-24-2016)
 -----------------------------------------------------------------------------------------------*/
 class ComputeParticleReset
@@ -29,44 +51,52 @@ public:
     bool AddEmitter(const IParticleEmitter *pEmitter);
 
     void ResetParticles(unsigned int particlesPerEmitterPerFrame);
+    void ShareFreeParticleStack(unsigned int computeProgramId) const;
+    void RebuildFreeParticleStack();
+    void EmittersChanged();
+    unsigned int RandomSeed() const;
+    unsigned int FrameNumber() const;
 
 private:
+    void UpdateEmitterTable(unsigned int particlesPerEmitterPerFrame);
+
     unsigned int _totalParticleCount;
     unsigned int _computeProgramId;
 
-    //unsigned int _acParticleCounterBufferId;
-    //unsigned int _acRandSeedBufferId;
-
-    // the atomic counters are both in a single buffer
-    unsigned int _atomicCounterBufferId;
-
-    // this the atomic counter is used to enforce the number of emitted particles per emitter 
-    // per frame 
-    unsigned int _acParticleCounterOffset;
-
-    // another atomic counter is used as a seed for the random hash
-    // Note: Rather than needing to seed the position and velocity as I did in the 
-    // "single emitter" project, use an atomic counter.  If it reaches maximum unsigned int, 
-    // that is ok.  The value will wrap around to 0 and begin again.  
-    unsigned int _acRandSeedOffset;
+    // the shader's random numbers are keyed on the seed, which is picked once, and counted by 
+    // the frame number, which goes up with every ResetParticles(...)
+    unsigned int _randomSeed;
+    unsigned int _frameNumber;
 
     // unlike most OpenGL IDs, uniform locations are GLint
     int _unifLocParticleCount;
-    int _unifLocMaxParticleEmitCount;
-    int _unifLocMinParticleVelocity;
-    int _unifLocDeltaParticleVelocity;
-    int _unifLocUsePointEmitter;
-    int _unifLocPointEmitterCenter;
-    int _unifLocBarEmitterP1;
-    int _unifLocBarEmitterP2;
-    int _unifLocBarEmitterEmitDir;
+    int _unifLocNumEmitters;
+    int _unifLocTotalParticlesToEmit;
+    int _unifLocRebuildFreeParticleStack;
+    int _unifLocRandomSeed;
+    int _unifLocFrameNumber;
+
+    // a count (signed) followed by up to one particle index per particle
+    UintSsbo *_pFreeParticleStack;
+
+    // the stack is built from the particle buffer the first time that it is needed (by then, 
+    // the particle buffer is linked to the shader)
+    bool _haveFreeParticleStack;
 
     // all the updating heavy lifting goes on in the compute shader, so CPU cache coherency is 
     // not a concern for emitter storage on the CPU side and a std::vector<...> is acceptable
     // Note: The compute shader has no concept of inheritance.  Rather than store a single 
     // collection of IParticleEmitter pointers and cast them to either point or bar emitters on 
     // every update, just store them separately.
-    static const int MAX_EMITTERS = 4;
+    // Also Note: The limit is on both kinds together because they share the table.
+    static const unsigned int MAX_EMITTERS = 256;
     std::vector<const ParticleEmitterPoint *> _pointEmitters;
     std::vector<const ParticleEmitterBar *> _barEmitters;
+
+    // the table that the shader reads, as of the last upload
+    std::vector<ParticleEmitterTableEntry> _emitterTable;
+    ParticleEmitterSsbo *_pEmitterTableBuffer;
+    bool _emitterTableIsCurrent;
+    unsigned int _emitterTableParticlesPerEmitter;
+    unsigned int _totalParticlesToEmit;
 };
@@ -1,5 +1,6 @@
 #include "ComputeParticleUpdate.h"
 
+#include "ComputeActiveParticleCompaction.h"
 #include "ShaderStorage.h"
 #include "glload/include/glload/gl_4_4.h"
 #include "glm/gtc/type_ptr.hpp"
@@ -24,13 +25,19 @@ ComputeParticleUpdate::ComputeParticleUpdate(unsigned int numParticles,
     const std::string &computeShaderKey) :
     _totalParticleCount(0),
     _activeParticleCount(0),
+    _asleepParticleCount(0),
     _computeProgramId(0),
     _acParticleCounterBufferId(0),
     _acParticleCounterCopyBufferId(0),
+    _pActiveParticleList(0),
     _unifLocParticleCount(-1),
     _unifLocParticleRegionCenter(-1),
     _unifLocParticleRegionRadiusSqr(-1),
-    _unifLocDeltaTimeSec(-1)
+    _unifLocDeltaTimeSec(-1),
+    _unifLocFramesToSleep(-1),
+    _unifLocSleepMaxSpeedSqr(-1),
+    _unifLocSleepMaxForceSqr(-1),
+    _unifLocUseActiveParticleList(-1)
 {
     _totalParticleCount = numParticles;
 
@@ -40,6 +47,10 @@ ComputeParticleUpdate::ComputeParticleUpdate(unsigned int numParticles,
     _unifLocParticleRegionCenter = shaderStorageRef.GetUniformLocation(computeShaderKey, "uParticleRegionCenter");
     _unifLocParticleRegionRadiusSqr = shaderStorageRef.GetUniformLocation(computeShaderKey, "uParticleRegionRadiusSqr");
     _unifLocDeltaTimeSec = shaderStorageRef.GetUniformLocation(computeShaderKey, "uDeltaTimeSec");
+    _unifLocFramesToSleep = shaderStorageRef.GetUniformLocation(computeShaderKey, "uFramesToSleep");
+    _unifLocSleepMaxSpeedSqr = shaderStorageRef.GetUniformLocation(computeShaderKey, "uSleepMaxSpeedSqr");
+    _unifLocSleepMaxForceSqr = shaderStorageRef.GetUniformLocation(computeShaderKey, "uSleepMaxForceSqr");
+    _unifLocUseActiveParticleList = shaderStorageRef.GetUniformLocation(computeShaderKey, "uUseActiveParticleList");
 
     _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
 
@@ -50,21 +61,29 @@ ComputeParticleUpdate::ComputeParticleUpdate(unsigned int numParticles,
     glUniform1f(_unifLocParticleRegionRadiusSqr, particleRegionRadius * particleRegionRadius);
     // delta time set in Update(...)
 
+    // no sleeping until told otherwise
+    glUniform1ui(_unifLocFramesToSleep, 0);
+    glUniform1f(_unifLocSleepMaxSpeedSqr, 0.0f);
+    glUniform1f(_unifLocSleepMaxForceSqr, 0.0f);
+
+    // every particle until told otherwise
+    glUniform1ui(_unifLocUseActiveParticleList, 0);
+
     // atomic counter initialization courtesy of geeks3D (and my use of glBufferData(...) 
     // instead of glMapBuffer(...)
     // http://www.geeks3d.com/20120309/opengl-4-2-atomic-counter-demo-rendering-order-of-fragments/
 
-    // particle counter
+    // particle counters (active, then asleep)
     glGenBuffers(1, &_acParticleCounterBufferId);
     glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _acParticleCounterBufferId);
-    GLuint atomicCounterResetVal = 0;
-    glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(GLuint), (void *)&atomicCounterResetVal, GL_DYNAMIC_DRAW);
+    GLuint atomicCounterResetVals[2] = { 0, 0 };
+    glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(atomicCounterResetVals), (void *)atomicCounterResetVals, GL_DYNAMIC_DRAW);
     glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
 
     // the atomic counter copy buffer follows suit
     glGenBuffers(1, &_acParticleCounterCopyBufferId);
     glBindBuffer(GL_COPY_WRITE_BUFFER, _acParticleCounterCopyBufferId);
-    glBufferData(GL_COPY_WRITE_BUFFER, sizeof(GLuint), 0, GL_DYNAMIC_COPY);
+    glBufferData(GL_COPY_WRITE_BUFFER, sizeof(atomicCounterResetVals), 0, GL_DYNAMIC_COPY);
     glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
 
     // cleanup
@@ -100,7 +119,8 @@ ComputeParticleUpdate::~ComputeParticleUpdate()
 Description:
     Resets the atomic counter and dispatches the shader.
     
-    The number of work groups is based on the maximum number of particles.
+    The number of work groups is based on the maximum number of particles, or on the active 
+    list if there is one (see SetActiveParticleList(...)).
 Parameters:    
     deltaTimeSec    Self-explanatory
 Returns:    None
@@ -119,9 +139,16 @@ void ComputeParticleUpdate::Update(const float deltaTimeSec)
 
     glUniform1f(_unifLocDeltaTimeSec, deltaTimeSec);
     glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _acParticleCounterBufferId);
-    unsigned int atomicCounterResetValue = 0;
-    glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(GLuint), (void *)&atomicCounterResetValue);
-    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    unsigned int atomicCounterResetValues[2] = { 0, 0 };
+    glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(atomicCounterResetValues), (void *)atomicCounterResetValues);
+    if (_pActiveParticleList != 0)
+    {
+        _pActiveParticleList->DispatchOverActiveParticles();
+    }
+    else
+    {
+        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    }
     glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ATOMIC_COUNTER_BARRIER_BIT);
 
     // cleanup
@@ -134,10 +161,11 @@ void ComputeParticleUpdate::Update(const float deltaTimeSec)
     // (http://gamedev.stackexchange.com/questions/93726/what-is-the-fastest-way-of-reading-an-atomic-counter) 
     glBindBuffer(GL_COPY_READ_BUFFER, _acParticleCounterBufferId);
     glBindBuffer(GL_COPY_WRITE_BUFFER, _acParticleCounterCopyBufferId);
-    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeof(GLuint));
-    void *bufferPtr = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, sizeof(GLuint), GL_MAP_READ_BIT);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, 2 * sizeof(GLuint));
+    void *bufferPtr = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, 2 * sizeof(GLuint), GL_MAP_READ_BIT);
     unsigned int *particleCountPtr = static_cast<unsigned int *>(bufferPtr);
-    _activeParticleCount = *particleCountPtr;
+    _activeParticleCount = particleCountPtr[0];
+    _asleepParticleCount = particleCountPtr[1];
     glUnmapBuffer(GL_COPY_WRITE_BUFFER);
 
     // cleanup
@@ -145,6 +173,49 @@ void ComputeParticleUpdate::Update(const float deltaTimeSec)
     glBindBuffer(GL_COPY_READ_BUFFER, 0);
 }
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Turns on sleeping (see particleUpdate.comp).  A particle whose speed and net force have 
+    both been at or under the given limits for the given number of updates in a row is stopped 
+    and skipped by the update and collision shaders until a force over the limit wakes it up.
+Parameters:
+    framesToSleep   How many updates in a row a particle has to be at rest.  0 turns sleeping 
+                    off.
+    maxSpeed        Self-explanatory.
+    maxForce        Also the force that it takes to wake a particle up.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleUpdate::SetSleepThresholds(unsigned int framesToSleep, float maxSpeed, float maxForce)
+{
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocFramesToSleep, framesToSleep);
+    glUniform1f(_unifLocSleepMaxSpeedSqr, maxSpeed * maxSpeed);
+    glUniform1f(_unifLocSleepMaxForceSqr, maxForce * maxForce);
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Dispatches the shader over only the particles in the given active list instead of over 
+    every particle (see ComputeActiveParticleCompaction).  The list MUST be up to date every 
+    time that Update(...) is called.
+Parameters:
+    pActiveParticleList     0 goes back to every particle.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleUpdate::SetActiveParticleList(const ComputeActiveParticleCompaction *pActiveParticleList)
+{
+    _pActiveParticleList = pActiveParticleList;
+    if (_pActiveParticleList != 0)
+    {
+        _pActiveParticleList->ShareActiveParticleList(_computeProgramId);
+    }
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocUseActiveParticleList, (_pActiveParticleList != 0) ? 1 : 0);
+    glUseProgram(0);
+}
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     A simple getter for the number of particles that were active on the last Update(...) call.
@@ -157,3 +228,16 @@ unsigned int ComputeParticleUpdate::NumActiveParticles() const
 {
     return _activeParticleCount;
 }
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for how many of the active particles were asleep on the last Update(...) 
+    call.
+Parameters: None
+Returns:    
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeParticleUpdate::NumAsleepParticles() const
+{
+    return _asleepParticleCount;
+}
@@ -3,6 +3,8 @@
 #include <string>
 #include "glm/vec4.hpp"
 
+class ComputeActiveParticleCompaction;
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     Encapsulates the following particle updates via compute shader:
@@ -10,6 +12,8 @@ Description:
     previous frame.
     (2) If any particles have gone out of bounds, flag them as inactive.
     (3) Emit as many particles for this frame as each emitter allows.
+    (4) Put particles to sleep that have been nearly still for a while, and wake them up again 
+    when something hits them (off until SetSleepThresholds(...) is called).
 
     There is one compute shader that does this, and this class is built to communicate with and 
     summon that particular shader.
@@ -26,15 +30,19 @@ public:
     ~ComputeParticleUpdate();
 
     void Update(const float deltaTimeSec);
+    void SetSleepThresholds(unsigned int framesToSleep, float maxSpeed, float maxForce);
+    void SetActiveParticleList(const ComputeActiveParticleCompaction *pActiveParticleList);
     unsigned int NumActiveParticles() const;
+    unsigned int NumAsleepParticles() const;
 
 private:
     unsigned int _totalParticleCount;
     unsigned int _activeParticleCount;
+    unsigned int _asleepParticleCount;
     unsigned int _computeProgramId;
 
-    // the atomic counter is used to count the total number of active particles after this 
-    // update
+    // the atomic counters are used to count the total number of active particles after this 
+    // update and how many of those are asleep
     // Also Note: The copy buffer is necessary to avoid trashing OpenGL's beautifully 
     // synchronized pipeline.  Experiments showed that, after particle updating, mapping a 
     // pointer to the atomic counter dropped frame rates from ~60fps -> ~3fps.  Ouch.  But now 
@@ -44,9 +52,16 @@ private:
     unsigned int _acParticleCounterBufferId;
     unsigned int _acParticleCounterCopyBufferId;
 
+    // not owned; 0 if the shader is dispatched over every particle
+    const ComputeActiveParticleCompaction *_pActiveParticleList;
+
     // unlike most OpenGL IDs, uniform locations are GLint
     int _unifLocParticleCount;
     int _unifLocParticleRegionCenter;
     int _unifLocParticleRegionRadiusSqr;
     int _unifLocDeltaTimeSec;
+    int _unifLocFramesToSleep;
+    int _unifLocSleepMaxSpeedSqr;
+    int _unifLocSleepMaxForceSqr;
+    int _unifLocUseActiveParticleList;
 };
@@ -0,0 +1,214 @@
+#include "ComputeParticleVerletLists.h"
+
+#include "glload/include/glload/gl_4_4.h"
+#include "ShaderStorage.h"
+#include "UintSsbo.h"
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Finds the uniforms for the "Verlet check" compute shader and the Verlet list uniforms in 
+    the collision shader and gives them their values.  This turns on "Verlet list" mode in 
+    the collision shader.
+    Generates the lists, the reference positions, and the stats buffer, which only these two 
+    shaders use.
+Parameters:
+    maxParticles                Tells the shaders how big the particle buffer is.
+    skinDistance                How far past the particles' radii a neighbor can be.
+    checkComputeShaderKey       Used to look up the "Verlet check" shader's uniforms and 
+                                program ID.
+    collisionComputeShaderKey   Same, but for the collision shader.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeParticleVerletLists::ComputeParticleVerletLists(
+    unsigned int maxParticles,
+    float skinDistance,
+    const std::string &checkComputeShaderKey,
+    const std::string &collisionComputeShaderKey) :
+    _checkProgramId(0),
+    _collisionProgramId(0),
+    _totalParticles(0),
+    _numParticlesPastHalfSkin(0),
+    _haveLists(false),
+    _numFrames(0),
+    _numBuilds(0),
+    _numReuses(0),
+    _unifLocBuildVerletLists(-1),
+    _pVerletListBuffer(0),
+    _pReferencePositionBuffer(0),
+    _pStatsBuffer(0)
+{
+    _totalParticles = maxParticles;
+
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+    _checkProgramId = shaderStorageRef.GetShaderProgram(checkComputeShaderKey);
+    _collisionProgramId = shaderStorageRef.GetShaderProgram(collisionComputeShaderKey);
+    _unifLocBuildVerletLists = shaderStorageRef.GetUniformLocation(collisionComputeShaderKey, "uBuildVerletLists");
+
+    float halfSkin = skinDistance * 0.5f;
+    glUseProgram(_checkProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(checkComputeShaderKey, "uMaxParticles"), maxParticles);
+    glUniform1f(shaderStorageRef.GetUniformLocation(checkComputeShaderKey, "uHalfSkinSqr"), halfSkin * halfSkin);
+
+    glUseProgram(_collisionProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(collisionComputeShaderKey, "uUseVerletLists"), 1);
+    glUniform1ui(_unifLocBuildVerletLists, 0);
+    glUniform1f(shaderStorageRef.GetUniformLocation(collisionComputeShaderKey, "uVerletSkin"), skinDistance);
+    glUseProgram(0);
+
+    _pVerletListBuffer = new UintSsbo(maxParticles * VERLET_LIST_STRIDE);
+    _pVerletListBuffer->ConfigureCompute(_checkProgramId, "VerletListBuffer");
+    _pVerletListBuffer->ConfigureCompute(_collisionProgramId, "VerletListBuffer");
+
+    _pReferencePositionBuffer = new UintSsbo(maxParticles * 2);
+    _pReferencePositionBuffer->ConfigureCompute(_checkProgramId, "VerletReferencePositionBuffer");
+    _pReferencePositionBuffer->ConfigureCompute(_collisionProgramId, "VerletReferencePositionBuffer");
+
+    _pStatsBuffer = new UintSsbo(1);
+    _pStatsBuffer->ConfigureCompute(_checkProgramId, "VerletStatsBuffer");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up the buffers that this class owns.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeParticleVerletLists::~ComputeParticleVerletLists()
+{
+    delete _pVerletListBuffer;
+    delete _pReferencePositionBuffer;
+    delete _pStatsBuffer;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs the check shader and reads back how many particles have moved more than half the 
+    skin since the last build.  
+
+    MUST be called once per frame, after the particles are updated and before the collisions.  
+    If it returns true, then the spatial structure MUST be rebuilt and then BuildLists() MUST 
+    be called before the collisions.
+
+    Note: Reading the count back stalls the CPU until the check is done, same as the node 
+    count after subdivision.  It's the price of skipping the whole structure build on most 
+    frames.
+Parameters: None
+Returns:
+    True if the lists need to be rebuilt, otherwise false.
+-----------------------------------------------------------------------------------------------*/
+bool ComputeParticleVerletLists::ListsNeedRebuild()
+{
+    _numFrames++;
+    if (!_haveLists)
+    {
+        return true;
+    }
+
+    GLuint zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pStatsBuffer->BufferId());
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    GLuint numWorkGroupsX = (_totalParticles / 256) + 1;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_checkProgramId);
+    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    glUseProgram(0);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pStatsBuffer->BufferId());
+    void *bufferPtr = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GLuint), GL_MAP_READ_BIT);
+    unsigned int *countPtr = static_cast<unsigned int *>(bufferPtr);
+    _numParticlesPastHalfSkin = *countPtr;
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    if (_numParticlesPastHalfSkin > 0)
+    {
+        return true;
+    }
+
+    _numReuses++;
+    return false;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs the collision shader in "build Verlet lists" mode, which walks the spatial structure 
+    and records every particle's neighbors along with where the particle is now.
+
+    MUST be called after the spatial structure is rebuilt (and after the particles are 
+    reordered, if they are, because the lists hold particle indices).
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleVerletLists::BuildLists()
+{
+    GLuint numWorkGroupsX = (_totalParticles / 256) + 1;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_collisionProgramId);
+    glUniform1ui(_unifLocBuildVerletLists, 1);
+    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    glUniform1ui(_unifLocBuildVerletLists, 0);
+    glUseProgram(0);
+
+    _haveLists = true;
+    _numBuilds++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of particles that were past half the skin at the last call 
+    to ListsNeedRebuild().
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeParticleVerletLists::NumParticlesPastHalfSkin() const
+{
+    return _numParticlesPastHalfSkin;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The average number of frames that the lists have been kept for, since the program 
+    started.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+float ComputeParticleVerletLists::AverageFramesBetweenBuilds() const
+{
+    if (_numBuilds == 0)
+    {
+        return 0.0f;
+    }
+
+    return static_cast<float>(_numFrames) / static_cast<float>(_numBuilds);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The fraction of frames, since the program started, that reused the lists instead of 
+    rebuilding them (the "hit rate").
+Parameters: None
+Returns:
+    A value on the range [0,1].
+-----------------------------------------------------------------------------------------------*/
+float ComputeParticleVerletLists::ReuseRate() const
+{
+    if (_numFrames == 0)
+    {
+        return 0.0f;
+    }
+
+    return static_cast<float>(_numReuses) / static_cast<float>(_numFrames);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+
+class UintSsbo;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Controls the "Verlet list" mode of the collision shader.  
+
+    Every particle gets a list of the particles that are within both of their radii plus a 
+    "skin" distance.  The lists are built by running the collision shader over the spatial 
+    structure as usual, but it records neighbors instead of calculating collisions.  After 
+    that, the collision shader only runs each particle against its list, and the spatial 
+    structure isn't rebuilt at all.
+
+    Neighborhoods barely change from one 10ms frame to the next.  The lists are good until 
+    some particle has moved more than half the skin since they were built (two particles 
+    that each moved less than that can't have closed a gap bigger than the skin).  A check 
+    shader counts those particles every frame, and the count is read back to decide whether 
+    the spatial structure and the lists need to be rebuilt this frame.
+
+    This class owns the lists, the positions at the last build, and the check's stats buffer.
+-----------------------------------------------------------------------------------------------*/
+class ComputeParticleVerletLists
+{
+public:
+    ComputeParticleVerletLists(
+        unsigned int maxParticles,
+        float skinDistance,
+        const std::string &checkComputeShaderKey,
+        const std::string &collisionComputeShaderKey);
+    ~ComputeParticleVerletLists();
+
+    bool ListsNeedRebuild();
+    void BuildLists();
+
+    unsigned int NumParticlesPastHalfSkin() const;
+    float AverageFramesBetweenBuilds() const;
+    float ReuseRate() const;
+
+    // MUST match the values in quadTreeParticleCollisions.comp and particleVerletCheck.comp
+    static const unsigned int MAX_VERLET_NEIGHBORS = 63;
+    static const unsigned int VERLET_LIST_STRIDE = MAX_VERLET_NEIGHBORS + 1;
+
+private:
+    unsigned int _checkProgramId;
+    unsigned int _collisionProgramId;
+    unsigned int _totalParticles;
+    unsigned int _numParticlesPastHalfSkin;
+    bool _haveLists;
+
+    // for the rebuild interval and the reuse ("hit") rate
+    unsigned int _numFrames;
+    unsigned int _numBuilds;
+    unsigned int _numReuses;
+
+    // lives in the collision shader
+    int _unifLocBuildVerletLists;
+
+    // a count and then the neighbors' indices for each particle
+    UintSsbo *_pVerletListBuffer;
+
+    // X and Y for each particle
+    UintSsbo *_pReferencePositionBuffer;
+
+    // the number of particles that moved more than half the skin
+    UintSsbo *_pStatsBuffer;
+};
@@ -0,0 +1,220 @@
+#include "ComputeQuadTreeIncrementalUpdate.h"
+
+#include "glload/include/glload/gl_4_4.h"
+#include "glm/gtc/type_ptr.hpp"
+#include "ShaderStorage.h"
+#include "UintSsbo.h"
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Finds the uniforms for the "incremental update" compute shader and gives them initial 
+    values.  Generates the dirty node flags and the stats buffer, both of which only this 
+    shader uses.
+Parameters:
+    maxNodes                    Tells the shader how big the node buffers are.
+    maxParticles                Tells the shader how big the particle buffer is.
+    particleRegionRadius        Used when a particle is calculating its starting node.
+    particleRegionCenter        Ditto
+    numColumnsInTreeInitial     Ditto
+    numRowsInTreeInitial        Ditto
+    maxMovedFraction            If more than this fraction of the active particles moved, 
+                                UpdateTree() gives up and asks for a full rebuild.
+    fullRebuildIntervalFrames   Ask for a full rebuild at least this often (0 for never).
+    computeShaderKey            Used to look up the shader's uniforms and program ID.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeQuadTreeIncrementalUpdate::ComputeQuadTreeIncrementalUpdate(
+    unsigned int maxNodes,
+    unsigned int maxParticles,
+    float particleRegionRadius,
+    const glm::vec4 &particleRegionCenter,
+    unsigned int numColumnsInTreeInitial,
+    unsigned int numRowsInTreeInitial,
+    float maxMovedFraction,
+    unsigned int fullRebuildIntervalFrames,
+    const std::string &computeShaderKey) :
+    _computeProgramId(0),
+    _totalNodes(0),
+    _totalParticles(0),
+    _maxMovedFraction(0.0f),
+    _fullRebuildIntervalFrames(0),
+    _framesSinceFullRebuild(0),
+    _haveBuiltTree(false),
+    _didFullRebuild(false),
+    _numMovedParticles(0),
+    _numDirtyNodes(0),
+    _unifLocPass(-1),
+    _pDirtyNodeBuffer(0),
+    _pStatsBuffer(0)
+{
+    _totalNodes = maxNodes;
+    _totalParticles = maxParticles;
+    _maxMovedFraction = maxMovedFraction;
+    _fullRebuildIntervalFrames = fullRebuildIntervalFrames;
+
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+    _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
+    _unifLocPass = shaderStorageRef.GetUniformLocation(computeShaderKey, "uPass");
+
+    // same starting node math as ComputeQuadTreePopulate
+    float xIncrementPerColumn = 2.0f * particleRegionRadius / numColumnsInTreeInitial;
+    float yIncrementPerRow = 2.0f * particleRegionRadius / numRowsInTreeInitial;
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxNodes"), maxNodes);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxParticles"), maxParticles);
+    glUniform1f(shaderStorageRef.GetUniformLocation(computeShaderKey, "uParticleRegionRadius"), particleRegionRadius);
+    glUniform4fv(shaderStorageRef.GetUniformLocation(computeShaderKey, "uParticleRegionCenter"), 1, glm::value_ptr(particleRegionCenter));
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumColumnsInTreeInitial"), numColumnsInTreeInitial);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumRowsInTreeInitial"), numRowsInTreeInitial);
+    glUniform1f(shaderStorageRef.GetUniformLocation(computeShaderKey, "uInverseXIncrementPerColumn"), 1.0f / xIncrementPerColumn);
+    glUniform1f(shaderStorageRef.GetUniformLocation(computeShaderKey, "uInverseYIncrementPerRow"), 1.0f / yIncrementPerRow);
+    glUseProgram(0);
+
+    _pDirtyNodeBuffer = new UintSsbo(maxNodes);
+    _pDirtyNodeBuffer->ConfigureCompute(_computeProgramId, "QuadTreeDirtyNodeBuffer");
+
+    _pStatsBuffer = new UintSsbo(2);
+    _pStatsBuffer->ConfigureCompute(_computeProgramId, "QuadTreeIncrementalStatsBuffer");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up the buffers that this class owns.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeQuadTreeIncrementalUpdate::~ComputeQuadTreeIncrementalUpdate()
+{
+    delete _pDirtyNodeBuffer;
+    delete _pStatsBuffer;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs the "detect" pass and reads back how many particles moved.  If that's few enough, 
+    then it runs the "clear" and "insert" passes to fix up only the nodes that changed.
+
+    The caller MUST run ComputeQuadTreeSubdivide::SubdivideTree(true) afterwards if this 
+    returns true.  If it returns false, then nothing was changed except the particles' node 
+    indices, and the caller MUST reset and repopulate the tree from scratch.
+
+    Note: Reading the count back stalls the CPU until the "detect" pass is done.  It's needed 
+    right away to pick between the incremental update and a full rebuild.
+Parameters:
+    numActiveParticles  The "moved" fraction is out of this.
+Returns:
+    True if the tree was updated incrementally, otherwise false.
+-----------------------------------------------------------------------------------------------*/
+bool ComputeQuadTreeIncrementalUpdate::UpdateTree(unsigned int numActiveParticles)
+{
+    ClearBuffer(_pStatsBuffer->BufferId());
+    DispatchPass(DETECT_MOVES, _totalParticles);
+
+    // retrieve the stats (printed to screen)
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pStatsBuffer->BufferId());
+    void *bufferPtr = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, 2 * sizeof(GLuint), GL_MAP_READ_BIT);
+    unsigned int *statsPtr = static_cast<unsigned int *>(bufferPtr);
+    _numMovedParticles = statsPtr[0];
+    _numDirtyNodes = statsPtr[1];
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    _framesSinceFullRebuild++;
+    bool tooManyMoved = _numMovedParticles > (unsigned int)(_maxMovedFraction * numActiveParticles);
+    bool rebuildIsDue = (_fullRebuildIntervalFrames > 0) && (_framesSinceFullRebuild >= _fullRebuildIntervalFrames);
+    _didFullRebuild = !_haveBuiltTree || tooManyMoved || rebuildIsDue;
+    if (!_didFullRebuild)
+    {
+        DispatchPass(CLEAR_DIRTY_NODES, _totalNodes);
+        DispatchPass(INSERT_INTO_DIRTY_NODES, _totalParticles);
+    }
+    else
+    {
+        _haveBuiltTree = true;
+        _framesSinceFullRebuild = 0;
+    }
+
+    // the flags are only good for this frame
+    ClearBuffer(_pDirtyNodeBuffer->BufferId());
+
+    return !_didFullRebuild;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of particles that changed nodes (or left the tree) in the 
+    last call to UpdateTree().
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeQuadTreeIncrementalUpdate::NumMovedParticles() const
+{
+    return _numMovedParticles;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of nodes that particles moved into or out of in the last 
+    call to UpdateTree().
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeQuadTreeIncrementalUpdate::NumDirtyNodes() const
+{
+    return _numDirtyNodes;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for whether the last call to UpdateTree() gave up and asked for a full 
+    rebuild.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+bool ComputeQuadTreeIncrementalUpdate::DidFullRebuild() const
+{
+    return _didFullRebuild;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets the pass uniform and dispatches the shader once per item.
+Parameters:
+    pass        Self-explanatory.
+    numItems    Particles or nodes, depending on the pass.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeQuadTreeIncrementalUpdate::DispatchPass(IncrementalPass pass, unsigned int numItems)
+{
+    GLuint numWorkGroupsX = (numItems / 256) + 1;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocPass, pass);
+    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets every value in one of this class' buffers to 0.
+Parameters:
+    bufferId    Self-explanatory.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeQuadTreeIncrementalUpdate::ClearBuffer(unsigned int bufferId)
+{
+    GLuint zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, bufferId);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include "glm/vec4.hpp"
+
+class UintSsbo;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Controls the compute shader that keeps the quad tree up to date from one frame to the next 
+    without wiping it out.  At the hard-coded delta time, most particles stay in the same leaf 
+    from one frame to the next, so resetting and repopulating every node (see 
+    ComputeQuadTreeReset and ComputeQuadTreePopulate) does a lot of work to end up where it 
+    started.
+
+    It takes three passes of the same shader:
+    (1) "detect": One invocation per particle.  Each particle finds its leaf in last frame's 
+    tree.  If that isn't the node that it was put into last time, or if it went inactive, then 
+    both nodes are flagged "dirty" and the particle takes the new node.
+    (2) "clear": One invocation per node.  Dirty nodes have their counts cleared.
+    (3) "insert": One invocation per particle.  Every particle in a dirty node adds itself to 
+    it again.  This is how particles are removed from the node that they left: the node is 
+    rebuilt from the particles that are still in it.
+    Nodes that nothing moved into or out of are left alone.  The "subdivide" passes still run 
+    afterwards (without resetting the node pool) to split up any dirty node that overflowed.
+
+    The number of particles that moved is read back after the "detect" pass.  If it is more 
+    than a given fraction of the active particles, then the incremental update isn't worth it, 
+    and UpdateTree() returns false so that the caller can rebuild the tree from scratch.  The 
+    tree is also rebuilt from scratch every so often because nodes are never merged back 
+    together in the incremental update, so nodes that particles have left stay subdivided 
+    until then.
+-----------------------------------------------------------------------------------------------*/
+class ComputeQuadTreeIncrementalUpdate
+{
+public:
+    ComputeQuadTreeIncrementalUpdate(
+        unsigned int maxNodes,
+        unsigned int maxParticles,
+        float particleRegionRadius,
+        const glm::vec4 &particleRegionCenter,
+        unsigned int numColumnsInTreeInitial,
+        unsigned int numRowsInTreeInitial,
+        float maxMovedFraction,
+        unsigned int fullRebuildIntervalFrames,
+        const std::string &computeShaderKey);
+    ~ComputeQuadTreeIncrementalUpdate();
+
+    bool UpdateTree(unsigned int numActiveParticles);
+    unsigned int NumMovedParticles() const;
+    unsigned int NumDirtyNodes() const;
+    bool DidFullRebuild() const;
+
+    // MUST match the order in quadTreeIncrementalUpdate.comp
+    enum IncrementalPass
+    {
+        DETECT_MOVES = 0,
+        CLEAR_DIRTY_NODES,
+        INSERT_INTO_DIRTY_NODES
+    };
+
+    // the node index of a particle that isn't in any node
+    // Note: MUST match the value in quadTreeIncrementalUpdate.comp.
+    static const unsigned int _NO_NODE = 0xffffffff;
+
+private:
+    void DispatchPass(IncrementalPass pass, unsigned int numItems);
+    void ClearBuffer(unsigned int bufferId);
+
+    unsigned int _computeProgramId;
+    unsigned int _totalNodes;
+    unsigned int _totalParticles;
+    float _maxMovedFraction;
+    unsigned int _fullRebuildIntervalFrames;
+    unsigned int _framesSinceFullRebuild;
+    bool _haveBuiltTree;
+    bool _didFullRebuild;
+    unsigned int _numMovedParticles;
+    unsigned int _numDirtyNodes;
+
+    int _unifLocPass;
+
+    // owned by this class
+    // Note: The stats buffer is two unsigned integers: the number of particles that moved and 
+    // the number of nodes that they dirtied.
+    UintSsbo *_pDirtyNodeBuffer;
+    UintSsbo *_pStatsBuffer;
+};
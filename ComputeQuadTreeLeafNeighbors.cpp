@@ -0,0 +1,50 @@
+#include "ComputeQuadTreeLeafNeighbors.h"
+
+#include "glload/include/glload/gl_4_4.h"
+#include "ShaderStorage.h"
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Finds the uniforms for the "leaf neighbors" compute shader and gives them initial values.
+Parameters:
+    maxNodes            Tells the shader how big the node buffers are.
+    computeShaderKey    Used to look up the shader's uniform and program ID.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeQuadTreeLeafNeighbors::ComputeQuadTreeLeafNeighbors(unsigned int maxNodes, 
+    const std::string &computeShaderKey) :
+    _computeProgramId(0),
+    _totalNodes(0)
+{
+    _totalNodes = maxNodes;
+
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+    _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
+
+    // this never changes, so don't bother keeping the uniform location around
+    glUseProgram(_computeProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxNodes"), maxNodes);
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Dispatches the shader with one invocation per node.
+
+    MUST be called after ComputeQuadTreeSubdivide::SubdivideTree().
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeQuadTreeLeafNeighbors::FindLeafNeighbors()
+{
+    GLuint numWorkGroupsX = (_totalNodes / 256) + 1;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_computeProgramId);
+    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    glUseProgram(0);
+}
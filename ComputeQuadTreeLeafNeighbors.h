@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Encapsulates the compute shader that gives every leaf of the quad tree a list of the leaves 
+    that touch it, including leaves that are at a different level of subdivision.  This runs 
+    after ComputeQuadTreeSubdivide::SubdivideTree() and before the collisions.
+
+    The neighbor indices that are stored in each node point at a node that is the same size or 
+    bigger (see quadTreeSubdivide.comp), and if that neighbor was subdivided, the collision 
+    shader used to have to walk down into it to find its leaves.  That walk was done by every 
+    particle in the leaf.  Now it is done once per leaf, and the collision shader's neighbor 
+    lookup is a straight read through a short list.
+
+    Note: No OpenGL objects are generated that need to be destroyed, so there is no destructor.
+-----------------------------------------------------------------------------------------------*/
+class ComputeQuadTreeLeafNeighbors
+{
+public:
+    ComputeQuadTreeLeafNeighbors(unsigned int maxNodes, const std::string &computeShaderKey);
+
+    void FindLeafNeighbors();
+
+private:
+    unsigned int _computeProgramId;
+    unsigned int _totalNodes;
+};
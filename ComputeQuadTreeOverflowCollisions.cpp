@@ -0,0 +1,138 @@
+#include "ComputeQuadTreeOverflowCollisions.h"
+
+#include "glload/include/glload/gl_4_4.h"
+#include "ShaderStorage.h"
+#include "UintSsbo.h"
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Finds the uniforms for the "overflow collisions" compute shader and gives them initial 
+    values.  Generates the overflow buffer, which only this shader uses.
+Parameters:
+    maxNodes                Tells the shader how big the node buffers are.
+    maxParticles            Tells the shader how big the particle buffer is.
+    maxOverflowParticles    How many overflow particles there is room for.  Any more than 
+                            this are counted but not collided with.
+    maxRadiusOfInfluence    The largest radius of any species.  Same as the regular collision 
+                            pass (see collisionReach.glsl).
+    computeShaderKey        Used to look up the shader's uniforms and program ID.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeQuadTreeOverflowCollisions::ComputeQuadTreeOverflowCollisions(
+    unsigned int maxNodes,
+    unsigned int maxParticles,
+    unsigned int maxOverflowParticles,
+    float maxRadiusOfInfluence,
+    const std::string &computeShaderKey) :
+    _computeProgramId(0),
+    _totalParticles(0),
+    _numOverflowParticles(0),
+    _unifLocPass(-1),
+    _unifLocInverseDeltaTimeSec(-1),
+    _pOverflowBuffer(0)
+{
+    _totalParticles = maxParticles;
+
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+    _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
+    _unifLocPass = shaderStorageRef.GetUniformLocation(computeShaderKey, "uPass");
+    _unifLocInverseDeltaTimeSec = shaderStorageRef.GetUniformLocation(computeShaderKey, "uInverseDeltaTimeSec");
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxNodes"), maxNodes);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxParticles"), maxParticles);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxOverflowParticles"), maxOverflowParticles);
+    glUniform1f(shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxRadiusOfInfluence"), maxRadiusOfInfluence);
+    glUseProgram(0);
+
+    // the count, then 2 unsigned integers per overflow particle
+    _pOverflowBuffer = new UintSsbo(1 + (2 * maxOverflowParticles));
+    _pOverflowBuffer->ConfigureCompute(_computeProgramId, "QuadTreeOverflowBuffer");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up the buffer that this class owns.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeQuadTreeOverflowCollisions::~ComputeQuadTreeOverflowCollisions()
+{
+    delete _pOverflowBuffer;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Clears the overflow count, gathers the overflow particles, reads back how many there were, 
+    and if there were any, runs the particles around them against them.
+
+    MUST be called after ComputeParticleQuadTreeCollisions::Update(...) and before the 
+    particles are updated again.
+
+    Note: Reading the count back stalls the CPU until the "gather" pass is done.  It's worth 
+    it to skip the "collide" pass on almost every frame.
+Parameters:
+    deltaTimeSec    Same as the regular collision pass.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeQuadTreeOverflowCollisions::Update(float deltaTimeSec)
+{
+    // only the count needs to be cleared; the list is written over
+    GLuint zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pOverflowBuffer->BufferId());
+    glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, 0, sizeof(GLuint), GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    DispatchPass(GATHER_OVERFLOW);
+
+    // retrieve the count (printed to screen)
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pOverflowBuffer->BufferId());
+    void *bufferPtr = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GLuint), GL_MAP_READ_BIT);
+    unsigned int *countPtr = static_cast<unsigned int *>(bufferPtr);
+    _numOverflowParticles = *countPtr;
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    if (_numOverflowParticles > 0)
+    {
+        glUseProgram(_computeProgramId);
+        glUniform1f(_unifLocInverseDeltaTimeSec, 1.0f / deltaTimeSec);
+        DispatchPass(COLLIDE_WITH_OVERFLOW);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of particles that didn't fit into their leaf in the last 
+    call to Update(...).  This may be more than the overflow buffer could hold.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeQuadTreeOverflowCollisions::NumOverflowParticles() const
+{
+    return _numOverflowParticles;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets the pass uniform and dispatches the shader once per particle.
+Parameters:
+    pass    Self-explanatory.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeQuadTreeOverflowCollisions::DispatchPass(OverflowPass pass)
+{
+    GLuint numWorkGroupsX = (_totalParticles / 256) + 1;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocPass, pass);
+    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    glUseProgram(0);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+
+class UintSsbo;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Controls the compute shader that catches the particles that didn't fit into their leaf.  
+
+    A leaf only has room for MAX_PARTICLES_PER_QUAD_TREE_NODE particle indices.  If more 
+    particles than that are in it, the leaf is subdivided, but if it can't be (out of nodes or 
+    at the subdivision level limit), the extra particles are left out of it.  The regular 
+    collision pass still runs those particles against everything around them, but nothing is 
+    run against them, so other particles pass right through them.  In a burst, that is a lot 
+    of missed collisions.
+
+    This runs after the regular collision pass (node version of the quad tree only), in two 
+    passes of the same shader:
+    (1) "gather": One invocation per particle.  Particles that aren't in their leaf's 
+    particle indices are added to an overflow list along with their leaf.
+    (2) "collide": One invocation per particle.  Particles next to a leaf that overflowed are 
+    run against that leaf's overflow particles (brute force through the list).
+    The number of overflow particles is read back after the "gather" pass, and the "collide" 
+    pass is skipped if there aren't any, which is the usual case.
+
+    This class owns the overflow buffer.
+-----------------------------------------------------------------------------------------------*/
+class ComputeQuadTreeOverflowCollisions
+{
+public:
+    ComputeQuadTreeOverflowCollisions(
+        unsigned int maxNodes,
+        unsigned int maxParticles,
+        unsigned int maxOverflowParticles,
+        float maxRadiusOfInfluence,
+        const std::string &computeShaderKey);
+    ~ComputeQuadTreeOverflowCollisions();
+
+    void Update(float deltaTimeSec);
+    unsigned int NumOverflowParticles() const;
+
+    // MUST match the order in quadTreeOverflowCollisions.comp
+    enum OverflowPass
+    {
+        GATHER_OVERFLOW = 0,
+        COLLIDE_WITH_OVERFLOW
+    };
+
+private:
+    void DispatchPass(OverflowPass pass);
+
+    unsigned int _computeProgramId;
+    unsigned int _totalParticles;
+    unsigned int _numOverflowParticles;
+
+    int _unifLocPass;
+    int _unifLocInverseDeltaTimeSec;
+
+    // a count followed by (particle index, node index) pairs
+    UintSsbo *_pOverflowBuffer;
+};
@@ -1,31 +1,84 @@
 #include "ComputeQuadTreeParticleCollisions.h"
 
 #include "glload/include/glload/gl_4_4.h"
+#include "glm/gtc/type_ptr.hpp"
+#include "ComputeActiveParticleCompaction.h"
 #include "ShaderStorage.h"
+#include "UintSsbo.h"
 
 
 /*-----------------------------------------------------------------------------------------------
 Description:
     Gives members initial values.
     Finds the uniforms for the "particle collisions" compute shader and gives them initial values.
+    Generates the "pair once" force buffer and the contact buffer.  Starts in per-particle mode 
+    without the contact list.
 Parameters:
     maxParticles            Tells the shader how big the "particle" buffer is.
+    maxContacts             How many contacts there is room for in "contact list" mode.  
+                            Any more than this are counted but dropped.
+    numColumnsInTreeInitial Used to find a cell's neighbors in the "cell list".
+    numRowsInTreeInitial    Ditto
+    particleRegionRadius    Used to turn a position into Morton coordinates when walking the 
+                            Morton quad tree.
+    particleRegionCenter    Ditto
+    maxRadiusOfInfluence    The largest radius of any species.  A node or leaf that is farther 
+                            than a particle's radius plus this can't hold anything that it 
+                            touches.
     computeShaderKey        Used to look up the shader's uniform and program ID.
+    contactResponseComputeShaderKey     Same, but for the "contact response" shader.
 Returns:    None
 Creator:    John Cox (1-21-2017)
 -----------------------------------------------------------------------------------------------*/
-ComputeParticleQuadTreeCollisions::ComputeParticleQuadTreeCollisions(unsigned int maxParticles, const std::string computeShaderKey) :
+ComputeParticleQuadTreeCollisions::ComputeParticleQuadTreeCollisions(
+    unsigned int maxParticles, 
+    unsigned int maxContacts, 
+    unsigned int numColumnsInTreeInitial, 
+    unsigned int numRowsInTreeInitial, 
+    float particleRegionRadius, 
+    const glm::vec4 &particleRegionCenter, 
+    float maxRadiusOfInfluence, 
+    const std::string computeShaderKey, 
+    const std::string contactResponseComputeShaderKey) :
     _computeProgramId(0),
+    _contactResponseProgramId(0),
     _totalParticles(0),
+    _maxContacts(0),
+    _numContacts(0),
+    _pairOnce(false),
+    _contactList(false),
+    _contactResponse(true),
+    _maxParticleSpeed(0.0f),
+    _sleepingParticles(false),
+    _particleMirror(false),
+    _pActiveParticleList(0),
     _unifLocMaxParticles(-1),
-    _unifLocInverseDeltaTimeSec(-1)
+    _unifLocInverseDeltaTimeSec(-1),
+    _unifLocPairOnce(-1),
+    _unifLocApplyPairForces(-1),
+    _unifLocRecordContacts(-1),
+    _unifLocSweptCollisions(-1),
+    _unifLocMaxStepDisplacement(-1),
+    _unifLocUseParticleMirror(-1),
+    _unifLocUseActiveParticleList(-1),
+    _unifLocContactResponseInverseDeltaTimeSec(-1),
+    _pPairForceBuffer(0),
+    _pContactBuffer(0)
 {
     _totalParticles = maxParticles;
+    _maxContacts = maxContacts;
 
     ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
 
     _unifLocMaxParticles = shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxParticles");
     _unifLocInverseDeltaTimeSec = shaderStorageRef.GetUniformLocation(computeShaderKey, "uInverseDeltaTimeSec");
+    _unifLocPairOnce = shaderStorageRef.GetUniformLocation(computeShaderKey, "uPairOnce");
+    _unifLocApplyPairForces = shaderStorageRef.GetUniformLocation(computeShaderKey, "uApplyPairForces");
+    _unifLocRecordContacts = shaderStorageRef.GetUniformLocation(computeShaderKey, "uRecordContacts");
+    _unifLocSweptCollisions = shaderStorageRef.GetUniformLocation(computeShaderKey, "uSweptCollisions");
+    _unifLocMaxStepDisplacement = shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxStepDisplacement");
+    _unifLocUseParticleMirror = shaderStorageRef.GetUniformLocation(computeShaderKey, "uUseParticleMirror");
+    _unifLocUseActiveParticleList = shaderStorageRef.GetUniformLocation(computeShaderKey, "uUseActiveParticleList");
 
     _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
 
@@ -33,17 +86,71 @@ ComputeParticleQuadTreeCollisions::ComputeParticleQuadTreeCollisions(unsigned in
 
     // uniform initialization
     glUniform1ui(_unifLocMaxParticles, maxParticles);
+    glUniform1ui(_unifLocPairOnce, 0);
+    glUniform1ui(_unifLocApplyPairForces, 0);
+    glUniform1ui(_unifLocRecordContacts, 0);
+    glUniform1ui(_unifLocSweptCollisions, 0);
+    glUniform1ui(_unifLocUseParticleMirror, 0);
+    glUniform1ui(_unifLocUseActiveParticleList, 0);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxContacts"), maxContacts);
 
-    // the "inverse delta time" uniform will be uploaded in Update(...)
+    // the spatial structure uniforms don't need to stick around because they don't change
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumColumnsInTreeInitial"), numColumnsInTreeInitial);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumRowsInTreeInitial"), numRowsInTreeInitial);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumSortedItems"), maxParticles);
+    glUniform1f(shaderStorageRef.GetUniformLocation(computeShaderKey, "uParticleRegionRadius"), particleRegionRadius);
+    glUniform4fv(shaderStorageRef.GetUniformLocation(computeShaderKey, "uParticleRegionCenter"), 1, glm::value_ptr(particleRegionCenter));
+    glUniform1f(shaderStorageRef.GetUniformLocation(computeShaderKey, "uInverseParticleRegionWidth"), 1.0f / (2.0f * particleRegionRadius));
+    glUniform1f(shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxRadiusOfInfluence"), maxRadiusOfInfluence);
+
+    // the "inverse delta time" and "max step displacement" uniforms will be uploaded in 
+    // Update(...)
 
     glUseProgram(0);
+
+    // starts out as all zeros, and the "apply" pass sets each particle's forces back to 0 
+    // after adding them in, so it never needs to be cleared on the CPU side
+    // Note: The shader uses signed integers, but an int and a uint of 0 are the same bits.
+    _pPairForceBuffer = new UintSsbo(2 * maxParticles);
+    _pPairForceBuffer->ConfigureCompute(_computeProgramId, "PairForceBuffer");
+
+    // the "contact response" shader
+    _contactResponseProgramId = shaderStorageRef.GetShaderProgram(contactResponseComputeShaderKey);
+    _unifLocContactResponseInverseDeltaTimeSec = shaderStorageRef.GetUniformLocation(contactResponseComputeShaderKey, "uInverseDeltaTimeSec");
+    glUseProgram(_contactResponseProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(contactResponseComputeShaderKey, "uMaxContacts"), maxContacts);
+    glUseProgram(0);
+    _pPairForceBuffer->ConfigureCompute(_contactResponseProgramId, "PairForceBuffer");
+
+    // the count is padded to 8 bytes (std430 alignment of the uvec2 array), then 2 unsigned 
+    // integers per contact
+    _pContactBuffer = new UintSsbo(2 + (2 * maxContacts));
+    _pContactBuffer->ConfigureCompute(_computeProgramId, "ContactBuffer");
+    _pContactBuffer->ConfigureCompute(_contactResponseProgramId, "ContactBuffer");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up the buffers that this class owns.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeParticleQuadTreeCollisions::~ComputeParticleQuadTreeCollisions()
+{
+    delete _pPairForceBuffer;
+    delete _pContactBuffer;
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Dispatches the shader.  
+    Dispatches the shader.  In "pair once" mode, the shader is dispatched again to add in the 
+    forces that each particle was given by other particles.  Same if particles can sleep.
+
+    In "contact list" mode, the "contact response" shader is run in between (see 
+    CalculateContacts()), and the forces are always added in afterwards.
 
-    The number of work groups is based on the maximum number of particles.
+    The number of work groups is based on the maximum number of particles, or on the active 
+    list if there is one (see SetActiveParticleList(...)).
 Parameters: None
 Returns:    None
 Creator:    John Cox (1-21-2017)
@@ -69,10 +176,279 @@ void ComputeParticleQuadTreeCollisions::Update(float deltaTimeSec)
     float inverseDeltaTime = 1.0f / deltaTimeSec;
     glUniform1f(_unifLocInverseDeltaTimeSec, inverseDeltaTime);
 
-    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    // swept collisions: the farthest that any particle could have moved during this update
+    glUniform1f(_unifLocMaxStepDisplacement, _maxParticleSpeed * deltaTimeSec);
+
+    if (_contactList)
+    {
+        // only the count needs to be cleared; the list is written over
+        GLuint zero = 0;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pContactBuffer->BufferId());
+        glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, 0, sizeof(GLuint), GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        glUseProgram(_contactResponseProgramId);
+        glUniform1f(_unifLocContactResponseInverseDeltaTimeSec, inverseDeltaTime);
+        glUseProgram(_computeProgramId);
+    }
+
+    if (_pActiveParticleList != 0)
+    {
+        _pActiveParticleList->DispatchOverActiveParticles();
+    }
+    else
+    {
+        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    }
     glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+    if (_contactList)
+    {
+        CalculateContacts();
+        glUseProgram(_computeProgramId);
+    }
+
+    if (_pairOnce || _contactList || _sleepingParticles)
+    {
+        glUniform1ui(_unifLocApplyPairForces, 1);
+        if (_pActiveParticleList != 0)
+        {
+            _pActiveParticleList->DispatchOverActiveParticles();
+        }
+        else
+        {
+            glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+        }
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+        glUniform1ui(_unifLocApplyPairForces, 0);
+    }
+
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Switches between "pair once" mode and per-particle mode.  They give the same result, so 
+    this can be done at any time (main(...) flips it back and forth to compare them).
+Parameters:
+    pairOnce    Self-explanatory.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleQuadTreeCollisions::SetPairOnce(bool pairOnce)
+{
+    _pairOnce = pairOnce;
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocPairOnce, pairOnce ? 1 : 0);
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for whether "pair once" mode is on.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+bool ComputeParticleQuadTreeCollisions::PairOnce() const
+{
+    return _pairOnce;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Switches "contact list" mode on or off.  Like "pair once" mode, this doesn't change the 
+    result, so it can be done at any time.  It works with or without "pair once" mode.
+Parameters:
+    contactList     Self-explanatory.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleQuadTreeCollisions::SetContactList(bool contactList)
+{
+    _contactList = contactList;
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocRecordContacts, contactList ? 1 : 0);
+    glUseProgram(0);
+    if (!contactList)
+    {
+        _numContacts = 0;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of contacts that were found in the last call to 
+    Update(...) in "contact list" mode.  This may be more than the contact buffer could hold.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeParticleQuadTreeCollisions::NumContacts() const
+{
+    return _numContacts;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the contact buffer, for anything else that wants to use the frame's 
+    contacts (see ContactBuffer in quadTreeParticleCollisions.comp for the layout).
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeParticleQuadTreeCollisions::ContactBufferId() const
+{
+    return _pContactBuffer->BufferId();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Links the contact buffer up with another compute shader that wants to use the frame's 
+    contacts.  The shader MUST declare it the same way as ContactBuffer in 
+    quadTreeParticleCollisions.comp.
+Parameters:
+    computeProgramId    Self-explanatory.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleQuadTreeCollisions::ShareContactBuffer(unsigned int computeProgramId) const
+{
+    _pContactBuffer->ConfigureCompute(computeProgramId, "ContactBuffer");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Turns the "contact response" shader on or off.  If off, "contact list" mode still finds 
+    and counts the contacts, but nothing is done about them here, so something else (such as 
+    ComputeParticleContactSolver) MUST take care of them or the particles will pass through 
+    each other.
+Parameters:
+    contactResponse     Self-explanatory.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleQuadTreeCollisions::SetContactResponse(bool contactResponse)
+{
+    _contactResponse = contactResponse;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Reads back the number of contacts that the collision shader found, and if there were any, 
+    runs the "contact response" shader once per contact (unless it was turned off).
+
+    Note: Reading the count back stalls the CPU until the collision shader is done, same as 
+    the overflow collisions (see ComputeQuadTreeOverflowCollisions::Update(...)), but the 
+    count is needed to size the dispatch, and it is a stat worth showing.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleQuadTreeCollisions::CalculateContacts()
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _pContactBuffer->BufferId());
+    void *bufferPtr = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GLuint), GL_MAP_READ_BIT);
+    unsigned int *countPtr = static_cast<unsigned int *>(bufferPtr);
+    _numContacts = *countPtr;
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    unsigned int numContactsInBuffer = (_numContacts < _maxContacts) ? _numContacts : _maxContacts;
+    if (numContactsInBuffer == 0 || !_contactResponse)
+    {
+        return;
+    }
+
+    GLuint numWorkGroupsX = (numContactsInBuffer / 256) + 1;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_contactResponseProgramId);
+    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
     glUseProgram(0);
+}
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Switches "swept collisions" mode on or off (see the class description).
+Parameters:
+    sweptCollisions     Self-explanatory.
+    maxParticleSpeed    The fastest that any particle is expected to go.  Multiplied by delta 
+                        time in Update(...) to find how far the node version of the quad tree 
+                        needs to look for particles that might have passed through each other.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleQuadTreeCollisions::SetSweptCollisions(bool sweptCollisions, float maxParticleSpeed)
+{
+    _maxParticleSpeed = maxParticleSpeed;
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocSweptCollisions, sweptCollisions ? 1 : 0);
+    glUseProgram(0);
 }
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Tells this class whether particles can be asleep (see the class description).  MUST be on 
+    if ComputeParticleUpdate puts particles to sleep, or they will never feel anything that 
+    runs into them.
+Parameters:
+    sleepingParticles   Self-explanatory.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleQuadTreeCollisions::SetSleepingParticles(bool sleepingParticles)
+{
+    _sleepingParticles = sleepingParticles;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Switches "particle mirror" mode on or off (see the class description).  Like "pair once" 
+    mode, this doesn't change the result (other than the halves that the radius and mass are 
+    rounded to), so it can be done at any time (main(...) flips it back and forth to compare 
+    them).
+
+    Note: The mirror buffer MUST be configured for the collision shader as 
+    "ParticleMirrorBuffer" before this is turned on.
+Parameters:
+    particleMirror  Self-explanatory.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleQuadTreeCollisions::SetParticleMirror(bool particleMirror)
+{
+    _particleMirror = particleMirror;
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocUseParticleMirror, particleMirror ? 1 : 0);
+    glUseProgram(0);
+}
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for whether "particle mirror" mode is on.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+bool ComputeParticleQuadTreeCollisions::ParticleMirror() const
+{
+    return _particleMirror;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Dispatches the shader over only the particles in the given active list instead of over 
+    every particle (see ComputeActiveParticleCompaction).  The list MUST be up to date every 
+    time that Update(...) is called.
+Parameters:
+    pActiveParticleList     0 goes back to every particle.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeParticleQuadTreeCollisions::SetActiveParticleList(const ComputeActiveParticleCompaction *pActiveParticleList)
+{
+    _pActiveParticleList = pActiveParticleList;
+    if (_pActiveParticleList != 0)
+    {
+        _pActiveParticleList->ShareActiveParticleList(_computeProgramId);
+    }
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocUseActiveParticleList, (_pActiveParticleList != 0) ? 1 : 0);
+    glUseProgram(0);
+}
@@ -1,29 +1,138 @@
 #pragma once
 
 #include <string>
+#include "glm/vec4.hpp"
 
+class UintSsbo;
+class ComputeActiveParticleCompaction;
 
 /*-----------------------------------------------------------------------------------------------
 Description:
     Controls the compute shader that checks for particle collisions within nodes and their 
     neighbors.  There is one shader dispatched for every particle.
 
+    If the "cell list" version of the quad tree is in use (see ComputeCellListBuild), then the 
+    shader checks the particle's cell and the 8 cells around it instead.  If the Morton quad 
+    tree is in use (see ComputeMortonQuadTreeBuild), then the shader walks the tree down to 
+    the leaves that the particle reaches into.
+
+    "Pair once" mode: Normally each particle only changes itself, so every colliding pair is 
+    calculated twice, once by each particle.  In "pair once" mode, only the particle with the 
+    lower index calculates the pair and the other particle gets the opposite force through a 
+    buffer of fixed-point forces (no float atomics in GLSL 4.40), which a second dispatch of 
+    the same shader adds in.  In the node version of the quad tree, only leaves that are 
+    guaranteed to find each other do this (see LeafCanPairOnce(...) in the shader).  This 
+    class owns that buffer.
+
+    "Contact list" mode: The collision shader only finds the pairs of particles that are 
+    touching and appends them to a contact list (the "broadphase").  The count is read back, 
+    and then the "contact response" shader runs once per contact to calculate the collisions 
+    (the "narrowphase").  Its forces go through the same fixed-point buffer as "pair once" 
+    mode.  The list is left alone afterwards, so anything else that wants the frame's contacts 
+    can use it.  This class owns the contact buffer.  The contact response can be turned off 
+    so that something else calculates the collisions from the list instead (see 
+    ComputeParticleContactSolver).
+
+    "Swept collisions" mode: A particle that moves farther than its diameter in one update can 
+    pass straight through another one without them ever overlapping at the end of an update.  
+    In this mode, the shader also checks whether the two particles' paths from their previous 
+    positions brought them together during the update, and if so, calculates the collision 
+    from where they were at that moment and moves the particle back to there on the next 
+    update.  The node version of the quad tree widens its search by how far the particles can 
+    move.  This is always per-particle, so "pair once" and "contact list" modes are ignored 
+    while it is on.
+
+    Sleeping particles (see ComputeParticleUpdate::SetSleepThresholds(...)) don't run the 
+    shader.  Any particle that runs into one calculates the pair on its behalf and hands it 
+    the opposite force through the "pair once" buffer, so that buffer has to be added in 
+    whenever particles are allowed to sleep.
+
+    "Particle mirror" mode: The collision shader reads the other particle's position, 
+    velocity, radius, mass, and sleep state out of a compact copy that the update shader 
+    writes every frame instead of out of the full particle.  Most of the particles that are 
+    checked are not touching, and for them, only the mirror is read.  The full particle is 
+    only read once a collision is found (for the restitution, or for the previous positions in 
+    "swept collisions" mode).  The mirror buffer is not owned by this class because the update 
+    shader also writes to it.
+
+    With an active particle list (see ComputeActiveParticleCompaction), both dispatches only 
+    cover the active particles.  Sleeping particles are still in the list because they still 
+    need the "apply" pass.
+
 Creator:    John Cox (1-21-2017)
 -----------------------------------------------------------------------------------------------*/
 class ComputeParticleQuadTreeCollisions
 {
 public:
-    ComputeParticleQuadTreeCollisions(unsigned int maxParticles, const std::string computeShaderKey);
+    // the shader is compiled for only one of these (see the SPATIAL_STRUCTURE_* defines in 
+    // quadTreeParticleCollisions.comp)
+    enum SpatialStructure
+    {
+        QUAD_TREE_NODES = 0,
+        CELL_LIST = 1,
+        MORTON_QUAD_TREE = 2
+    };
+
+    ComputeParticleQuadTreeCollisions(
+        unsigned int maxParticles, 
+        unsigned int maxContacts, 
+        unsigned int numColumnsInTreeInitial, 
+        unsigned int numRowsInTreeInitial, 
+        float particleRegionRadius, 
+        const glm::vec4 &particleRegionCenter, 
+        float maxRadiusOfInfluence, 
+        const std::string computeShaderKey, 
+        const std::string contactResponseComputeShaderKey);
 
-    // no destructor because there are no buffers that need to be destroyed
+    ~ComputeParticleQuadTreeCollisions();
 
     void Update(float deltaTimeSec);
+    void SetPairOnce(bool pairOnce);
+    bool PairOnce() const;
+    void SetContactList(bool contactList);
+    unsigned int NumContacts() const;
+    unsigned int ContactBufferId() const;
+    void ShareContactBuffer(unsigned int computeProgramId) const;
+    void SetContactResponse(bool contactResponse);
+    void SetSweptCollisions(bool sweptCollisions, float maxParticleSpeed);
+    void SetSleepingParticles(bool sleepingParticles);
+    void SetParticleMirror(bool particleMirror);
+    bool ParticleMirror() const;
+    void SetActiveParticleList(const ComputeActiveParticleCompaction *pActiveParticleList);
 
 private:
+    void CalculateContacts();
+
     unsigned int _computeProgramId;
+    unsigned int _contactResponseProgramId;
     unsigned int _totalParticles;
+    unsigned int _maxContacts;
+    unsigned int _numContacts;
+    bool _pairOnce;
+    bool _contactList;
+    bool _contactResponse;
+    float _maxParticleSpeed;
+    bool _sleepingParticles;
+    bool _particleMirror;
+
+    // not owned; 0 if the shader is dispatched over every particle
+    const ComputeActiveParticleCompaction *_pActiveParticleList;
 
     int _unifLocMaxParticles;
     int _unifLocInverseDeltaTimeSec;
+    int _unifLocPairOnce;
+    int _unifLocApplyPairForces;
+    int _unifLocRecordContacts;
+    int _unifLocSweptCollisions;
+    int _unifLocMaxStepDisplacement;
+    int _unifLocUseParticleMirror;
+    int _unifLocUseActiveParticleList;
+    int _unifLocContactResponseInverseDeltaTimeSec;
+
+    // X and Y per particle, fixed point
+    UintSsbo *_pPairForceBuffer;
+
+    // a count (padded to 8 bytes) followed by pairs of particle indices
+    UintSsbo *_pContactBuffer;
 };
 
@@ -2,16 +2,14 @@
 
 #include "glload/include/glload/gl_4_4.h"
 #include "glm/gtc/type_ptr.hpp"
+#include "ComputeActiveParticleCompaction.h"
 #include "ShaderStorage.h"
 
-#include <vector>
-
 
 /*-----------------------------------------------------------------------------------------------
 Description:
     Gives members initial values.
     Finds the uniforms for the "populate quad tree" compute shader and gives them initial values.
-    Generates the atomic counters for this shader.  Values are set in PopulateTree().
 Parameters:
     maxNodes                Tells the shader how big the "quad tree node" buffer is.
     maxParticles            Tells the shader how big the "particle" buffer is.
@@ -38,15 +36,15 @@ ComputeQuadTreePopulate::ComputeQuadTreePopulate(
     _totalNodes(0),
     _activeNodes(0),
     _initialNodes(0),
-    _atomicCounterBufferId(0),
-    _acOffsetParticleCounterPerNode(0),
     _acNodesInUseCopyBufferId(0),
+    _pActiveParticleList(0),
     _unifLocMaxParticles(-1),
     _unifLocParticleRegionRadius(-1),
     _unifLocParticleRegionCenter(-1),
     _unifLocNumColumnsInTreeInitial(-1),
     _unifLocInverseXIncrementPerColumn(-1),
-    _unifLocInverseYIncrementPerRow(-1)
+    _unifLocInverseYIncrementPerRow(-1),
+    _unifLocUseActiveParticleList(-1)
 {
     _totalParticles = maxParticles;
     _totalNodes = maxNodes;
@@ -60,6 +58,7 @@ ComputeQuadTreePopulate::ComputeQuadTreePopulate(
     _unifLocNumColumnsInTreeInitial = shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumColumnsInTreeInitial");
     _unifLocInverseXIncrementPerColumn = shaderStorageRef.GetUniformLocation(computeShaderKey, "uInverseXIncrementPerColumn");
     _unifLocInverseYIncrementPerRow = shaderStorageRef.GetUniformLocation(computeShaderKey, "uInverseYIncrementPerRow");
+    _unifLocUseActiveParticleList = shaderStorageRef.GetUniformLocation(computeShaderKey, "uUseActiveParticleList");
 
     _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
 
@@ -79,65 +78,65 @@ ComputeQuadTreePopulate::ComputeQuadTreePopulate(
     glUniform1f(_unifLocInverseXIncrementPerColumn, inverseXIncrementPerColumn);
     glUniform1f(_unifLocInverseYIncrementPerRow, inverseYIncrementPerRow);
 
-    // atomic counters (1 per node)
-    glGenBuffers(1, &_atomicCounterBufferId);
-    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _atomicCounterBufferId);
-    glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(GLuint) * maxNodes, 0, GL_DYNAMIC_DRAW);
+    // only ComputeQuadTreeSubdivide turns this on, and it turns it back off when it's done
+    GLint unifLocRepopulateSubdividedNodes = shaderStorageRef.GetUniformLocation(computeShaderKey, "uRepopulateSubdividedNodes");
+    glUniform1ui(unifLocRepopulateSubdividedNodes, 0);
+
+    // every particle until told otherwise
+    glUniform1ui(_unifLocUseActiveParticleList, 0);
 
-    // now the copy buffer
+    // the copy buffer
     glGenBuffers(1, &_acNodesInUseCopyBufferId);
     glBindBuffer(GL_COPY_WRITE_BUFFER, _acNodesInUseCopyBufferId);
     glBufferData(GL_COPY_WRITE_BUFFER, sizeof(GLuint), 0, GL_DYNAMIC_COPY);
     glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
 
     // cleanup
-    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
     glUseProgram(0);
 
-    // don't need to have a program or bound buffer to set the buffer base
-    // Note: The binding and the offsets MUST match those in the "quad tree populate" compute shader.
-    _acOffsetParticleCounterPerNode = 0;
-    glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 3, _atomicCounterBufferId);
-
     // no base binding for the atomic counter copy buffer because that is not used in the shader
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Deletes the atomic counter buffer.
+    Deletes the atomic counter copy buffer.
 Parameters: None
 Returns:    None
 Creator:    John Cox (1-21-2017)
 -----------------------------------------------------------------------------------------------*/
 ComputeQuadTreePopulate::~ComputeQuadTreePopulate()
 {
-    glDeleteBuffers(1, &_atomicCounterBufferId);
+    glDeleteBuffers(1, &_acNodesInUseCopyBufferId);
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Resets the atomic counters and dispatches the shader.
+    Dispatches the shader.
+
+    The number of work groups is based on the maximum number of particles, or on the active 
+    list if there is one (see SetActiveParticleList(...)).
 
-    The number of work groups is based on the maximum number of particles.
+    Note: Nothing is reset here.  The nodes' counts are the counters, and 
+    ComputeQuadTreeReset::ResetQuadTree() sets them back to 0 on the GPU.
 Parameters: None
 Returns:    None
 Creator:    John Cox (1-21-2017)
 -----------------------------------------------------------------------------------------------*/
 void ComputeQuadTreePopulate::PopulateTree()
 {
-    // reset atomic counters
-    // Note: No program biding is required to bind and set the values of the atomic counters.
-    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _atomicCounterBufferId);
-    static std::vector<GLuint> allZeros(_totalNodes, 0);
-    glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, _acOffsetParticleCounterPerNode, sizeof(GLuint) * _totalNodes, allZeros.data());
-    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
-
     // calculate the number of work groups and start the magic
     GLuint numWorkGroupsX = (_totalParticles / 256) + 1;
     GLuint numWorkGroupsY = 1;
     GLuint numWorkGroupsZ = 1;
     glUseProgram(_computeProgramId);
-    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    if (_pActiveParticleList != 0)
+    {
+        _pActiveParticleList->DispatchOverActiveParticles();
+    }
+    else
+    {
+        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    }
     glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
     glUseProgram(0);
 
@@ -158,6 +157,28 @@ void ComputeQuadTreePopulate::PopulateTree()
     //glBindBuffer(GL_COPY_READ_BUFFER, 0);
 }
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Dispatches the shader over only the particles in the given active list instead of over 
+    every particle (see ComputeActiveParticleCompaction).  The list MUST be up to date every 
+    time that PopulateTree() is called.
+Parameters:
+    pActiveParticleList     0 goes back to every particle.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeQuadTreePopulate::SetActiveParticleList(const ComputeActiveParticleCompaction *pActiveParticleList)
+{
+    _pActiveParticleList = pActiveParticleList;
+    if (_pActiveParticleList != 0)
+    {
+        _pActiveParticleList->ShareActiveParticleList(_computeProgramId);
+    }
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocUseActiveParticleList, (_pActiveParticleList != 0) ? 1 : 0);
+    glUseProgram(0);
+}
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     A simple getter for the number of active nodes.  Used during drawing to report the number of 
@@ -3,6 +3,7 @@
 #include <string>
 #include "glm/vec4.hpp"
 
+class ComputeActiveParticleCompaction;
 
 /*-----------------------------------------------------------------------------------------------
 Description:
@@ -30,6 +31,12 @@ Description:
     "max particles per node" value a little beyond that, and let it run.  The only checks are to 
     prevent array overruns.  No subdivision, no reallocation, just excess space.
 
+    Update: Subdivision happens after all, just not in this shader.  This shader still only 
+    puts particles into the starting nodes, but it counts every particle that tried to get into 
+    a node, even the ones that didn't fit, and ComputeQuadTreeSubdivide splits up the nodes 
+    that overflowed in separate passes.  Those passes run this shader again (with a uniform 
+    switch) to move particles down into the new child nodes.
+
 Creator:    John Cox (1-16-2017)
 -----------------------------------------------------------------------------------------------*/
 class ComputeQuadTreePopulate
@@ -47,6 +54,7 @@ public:
     ~ComputeQuadTreePopulate();
 
     void PopulateTree();
+    void SetActiveParticleList(const ComputeActiveParticleCompaction *pActiveParticleList);
     unsigned int NumActiveNodes() const;
 
 private:
@@ -56,14 +64,13 @@ private:
     unsigned int _activeNodes;
     unsigned int _initialNodes;
 
-    // all atomic counts are lumped into one buffer
-    unsigned int _atomicCounterBufferId;
-    unsigned int _acOffsetParticleCounterPerNode;
-
     // similar to the copy atomic counter in ComputeParticleUpdate for "active particle count", 
     // this is an atomic counter copy buffer for "active node count"
     unsigned int _acNodesInUseCopyBufferId;
 
+    // not owned; 0 if the shader is dispatched over every particle
+    const ComputeActiveParticleCompaction *_pActiveParticleList;
+
     int _unifLocMaxParticles;
     int _unifLocParticleRegionRadius;
     int _unifLocParticleRegionCenter;
@@ -74,6 +81,7 @@ private:
     int _unifLocNumColumnsInTreeInitial;
     int _unifLocInverseXIncrementPerColumn;
     int _unifLocInverseYIncrementPerRow;
+    int _unifLocUseActiveParticleList;
 
 
 };
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "ComputeQuadTreeSubdivide.h"
+
+#include "glload/include/glload/gl_4_4.h"
+#include "ShaderStorage.h"
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Finds the uniforms for the "subdivide" compute shader and gives them initial values.  Also
+    finds the "repopulate" switch in the "populate" compute shader.
+    Generates the node allocator's atomic counter.  Its value is set in SubdivideTree().  The 
+    copy buffer starts out with the number of starting nodes so that the first read (see 
+    SubdivideTree()) has something sensible in it.
+Parameters:
+    numStartingNodes        Child nodes are handed out starting after these.
+    maxNodes                No child nodes are handed out at or past this index.
+    maxParticles            Tells how many work groups to dispatch for the "populate" shader.
+    maxSubdivisionLevels    How many times a starting node can be split.
+    computeShaderKey        Used to look up the "subdivide" shader's uniforms and program ID.
+    populateComputeShaderKey    Same, but for the "populate" shader.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeQuadTreeSubdivide::ComputeQuadTreeSubdivide(
+    unsigned int numStartingNodes,
+    unsigned int maxNodes,
+    unsigned int maxParticles,
+    unsigned int maxSubdivisionLevels,
+    const std::string &computeShaderKey,
+    const std::string &populateComputeShaderKey) :
+    _computeProgramId(0),
+    _populateProgramId(0),
+    _numStartingNodes(0),
+    _totalNodes(0),
+    _totalParticles(0),
+    _maxSubdivisionLevels(0),
+    _activeNodes(0),
+    _acNodesInUseBufferId(0),
+    _acNodesInUseCopyBufferId(0),
+    _unifLocMaxNodes(-1),
+    _unifLocRepopulateSubdividedNodes(-1)
+{
+    _numStartingNodes = numStartingNodes;
+    _totalNodes = maxNodes;
+    _totalParticles = maxParticles;
+    _maxSubdivisionLevels = maxSubdivisionLevels;
+    _activeNodes = numStartingNodes;
+
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+
+    _unifLocMaxNodes = shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxNodes");
+    _unifLocRepopulateSubdividedNodes = shaderStorageRef.GetUniformLocation(populateComputeShaderKey, "uRepopulateSubdividedNodes");
+
+    _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
+    _populateProgramId = shaderStorageRef.GetShaderProgram(populateComputeShaderKey);
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocMaxNodes, maxNodes);
+
+    // the node allocator
+    glGenBuffers(1, &_acNodesInUseBufferId);
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _acNodesInUseBufferId);
+    glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(GLuint), 0, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+
+    // and its copy buffer
+    glGenBuffers(1, &_acNodesInUseCopyBufferId);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _acNodesInUseCopyBufferId);
+    glBufferData(GL_COPY_WRITE_BUFFER, sizeof(GLuint), &_numStartingNodes, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    // cleanup
+    glUseProgram(0);
+
+    // the binding MUST match the one in the "subdivide" compute shader
+    glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 2, _acNodesInUseBufferId);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Deletes the atomic counter buffer and its copy.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeQuadTreeSubdivide::~ComputeQuadTreeSubdivide()
+{
+    glDeleteBuffers(1, &_acNodesInUseBufferId);
+    glDeleteBuffers(1, &_acNodesInUseCopyBufferId);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Resets the node allocator to the end of the starting nodes (unless told otherwise), and 
+    then alternates between subdividing overflowing nodes and moving those nodes' particles 
+    down into the new children for each level of subdivision.
+
+    MUST be called after ComputeQuadTreePopulate::PopulateTree() or after 
+    ComputeQuadTreeIncrementalUpdate::UpdateTree() returns true.
+
+    Note: The number of nodes in use is only for the screen, so it is read a frame late.  
+    Reading it right after the dispatches would stall the CPU until they were all done.  
+    Instead, the counter is copied on the GPU at the end of this call, and the copy is read at 
+    the start of the next one, by which point the frame that wrote it is (nearly always) done.
+Parameters:
+    keepNodesFromLastFrame  If true, the node allocator is not reset, so last frame's child 
+                            nodes stay in use and new ones are handed out after them.  Used 
+                            when the tree was updated incrementally instead of rebuilt.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeQuadTreeSubdivide::SubdivideTree(bool keepNodesFromLastFrame)
+{
+    // the number of nodes in use as of the last call (copied at the end of it, below)
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _acNodesInUseCopyBufferId);
+    void *bufferPtr = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, sizeof(GLuint), GL_MAP_READ_BIT);
+    unsigned int *nodeCountPtr = static_cast<unsigned int *>(bufferPtr);
+    _activeNodes = *nodeCountPtr;
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    // a subdivision that was attempted after the pool ran out still incremented the counter
+    if (_activeNodes > _totalNodes)
+    {
+        _activeNodes = _totalNodes;
+    }
+
+    if (!keepNodesFromLastFrame)
+    {
+        glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _acNodesInUseBufferId);
+        glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(GLuint), &_numStartingNodes);
+        glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+    }
+
+    GLuint numWorkGroupsXNodes = (_totalNodes / 256) + 1;
+    GLuint numWorkGroupsXParticles = (_totalParticles / 256) + 1;
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    glUseProgram(_populateProgramId);
+    glUniform1ui(_unifLocRepopulateSubdividedNodes, 1);
+
+    for (unsigned int level = 0; level < _maxSubdivisionLevels; level++)
+    {
+        glUseProgram(_computeProgramId);
+        glDispatchCompute(numWorkGroupsXNodes, numWorkGroupsY, numWorkGroupsZ);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_ATOMIC_COUNTER_BARRIER_BIT);
+
+        glUseProgram(_populateProgramId);
+        glDispatchCompute(numWorkGroupsXParticles, numWorkGroupsY, numWorkGroupsZ);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_ATOMIC_COUNTER_BARRIER_BIT);
+    }
+
+    // put the "populate" shader back to normal for the next frame
+    glUniform1ui(_unifLocRepopulateSubdividedNodes, 0);
+    glUseProgram(0);
+
+    // copy the number of nodes in use for the next call to read; this stays on the GPU, so 
+    // nothing waits for it
+    glBindBuffer(GL_COPY_READ_BUFFER, _acNodesInUseBufferId);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _acNodesInUseCopyBufferId);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeof(GLuint));
+
+    // cleanup
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of nodes (starting nodes plus child nodes) that were in use
+    after the call to SubdivideTree() before the last one (see SubdivideTree()).
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ComputeQuadTreeSubdivide::NumActiveNodes() const
+{
+    return _activeNodes;
+}
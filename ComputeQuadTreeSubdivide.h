@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Controls the subdivision of quad tree nodes that had more particles try to get into them
+    than they could hold.  This runs after the "populate" shader.
+
+    ComputeQuadTreePopulate describes why a shader can't subdivide a node at the moment that it
+    fills up: there is no mutex, and other invocations are adding particles to that same node
+    at the same time.  So subdivision is done in separate passes instead, where each dispatch
+    finishes before the next one starts:
+    (1) One shader invocation per node.  Any leaf node that overflowed takes 4 children from
+    the pool of nodes after the starting nodes (atomic counter) and flags itself as subdivided.
+    (2) One "populate" shader invocation per particle.  Any particle whose node was just
+    subdivided moves down into the appropriate child.
+    Repeat for as many levels as are allowed.
+
+    The number of levels is fixed for the program's run so that the CPU doesn't have to read
+    anything back from the GPU (that would stall the pipeline) to decide whether to keep going.
+    Passes with nothing to subdivide are cheap.
+-----------------------------------------------------------------------------------------------*/
+class ComputeQuadTreeSubdivide
+{
+public:
+    ComputeQuadTreeSubdivide(
+        unsigned int numStartingNodes,
+        unsigned int maxNodes,
+        unsigned int maxParticles,
+        unsigned int maxSubdivisionLevels,
+        const std::string &computeShaderKey,
+        const std::string &populateComputeShaderKey);
+    ~ComputeQuadTreeSubdivide();
+
+    void SubdivideTree(bool keepNodesFromLastFrame);
+    unsigned int NumActiveNodes() const;
+
+private:
+    unsigned int _computeProgramId;
+    unsigned int _populateProgramId;
+    unsigned int _numStartingNodes;
+    unsigned int _totalNodes;
+    unsigned int _totalParticles;
+    unsigned int _maxSubdivisionLevels;
+    unsigned int _activeNodes;
+
+    // the "nodes in use" atomic counter is the node allocator
+    unsigned int _acNodesInUseBufferId;
+
+    // see ComputeParticleUpdate for why the copy buffer is necessary
+    unsigned int _acNodesInUseCopyBufferId;
+
+    int _unifLocMaxNodes;
+
+    // lives in the "populate" shader
+    int _unifLocRepopulateSubdividedNodes;
+};
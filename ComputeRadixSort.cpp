@@ -0,0 +1,171 @@
+#include "ComputeRadixSort.h"
+
+#include "glload/include/glload/gl_4_4.h"
+#include "ShaderStorage.h"
+#include "UintSsbo.h"
+
+// MUST match the values in radixSortHistogram.comp and radixSortScatter.comp
+static const unsigned int RADIX_BITS_PER_PASS = 4;
+static const unsigned int RADIX_NUM_DIGITS = 16;
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Allocates the "temp" key and value buffers that every other pass writes into and the 
+    buffer of per-work group digit counts.
+    Finds the uniforms for the "histogram", "scan", and "scatter" compute shaders and gives 
+    the constant ones their values.
+Parameters:
+    numItems                    How many keys (and values) to sort.
+    keysBuffer                  Sorted in place.
+    valuesBuffer                Moved around in the same way as the keys.
+    histogramComputeShaderKey   Used to look up the "histogram" shader's uniforms and program.
+    scanComputeShaderKey        Same, but for the "scan" shader.
+    scatterComputeShaderKey     Same, but for the "scatter" shader.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeRadixSort::ComputeRadixSort(
+    unsigned int numItems,
+    UintSsbo *keysBuffer,
+    UintSsbo *valuesBuffer,
+    const std::string &histogramComputeShaderKey,
+    const std::string &scanComputeShaderKey,
+    const std::string &scatterComputeShaderKey) :
+    _histogramProgramId(0),
+    _scanProgramId(0),
+    _scatterProgramId(0),
+    _numItems(0),
+    _numWorkGroups(0),
+    _pKeysBuffer(0),
+    _pValuesBuffer(0),
+    _pTempKeysBuffer(0),
+    _pTempValuesBuffer(0),
+    _pDigitCountBuffer(0),
+    _unifLocHistogramBitShift(-1),
+    _unifLocScatterBitShift(-1)
+{
+    _numItems = numItems;
+    _numWorkGroups = (numItems / 256) + 1;
+    _pKeysBuffer = keysBuffer;
+    _pValuesBuffer = valuesBuffer;
+
+    unsigned int numDigitCounts = RADIX_NUM_DIGITS * _numWorkGroups;
+    _pTempKeysBuffer = new UintSsbo(numItems);
+    _pTempValuesBuffer = new UintSsbo(numItems);
+    _pDigitCountBuffer = new UintSsbo(numDigitCounts);
+
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+
+    _histogramProgramId = shaderStorageRef.GetShaderProgram(histogramComputeShaderKey);
+    _scanProgramId = shaderStorageRef.GetShaderProgram(scanComputeShaderKey);
+    _scatterProgramId = shaderStorageRef.GetShaderProgram(scatterComputeShaderKey);
+
+    _unifLocHistogramBitShift = shaderStorageRef.GetUniformLocation(histogramComputeShaderKey, "uBitShift");
+    _unifLocScatterBitShift = shaderStorageRef.GetUniformLocation(scatterComputeShaderKey, "uBitShift");
+
+    glUseProgram(_histogramProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(histogramComputeShaderKey, "uNumItems"), numItems);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(histogramComputeShaderKey, "uNumWorkGroups"), _numWorkGroups);
+
+    glUseProgram(_scanProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(scanComputeShaderKey, "uNumItems"), numDigitCounts);
+
+    glUseProgram(_scatterProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(scatterComputeShaderKey, "uNumItems"), numItems);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(scatterComputeShaderKey, "uNumWorkGroups"), _numWorkGroups);
+
+    // cleanup
+    glUseProgram(0);
+
+    // the digit counts are in the same place in every pass
+    _pDigitCountBuffer->ConfigureCompute(_histogramProgramId, "DigitCountBuffer");
+    _pDigitCountBuffer->ConfigureCompute(_scanProgramId, "PrefixScanBuffer");
+    _pDigitCountBuffer->ConfigureCompute(_scatterProgramId, "DigitCountBuffer");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Deletes the buffers that this class made.  The key and value buffers that were given to it 
+    are left alone.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ComputeRadixSort::~ComputeRadixSort()
+{
+    delete _pTempKeysBuffer;
+    delete _pTempValuesBuffer;
+    delete _pDigitCountBuffer;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs all the passes of the sort.  When it is done, the keys buffer is in ascending order 
+    and every value is at the same index as its key.
+
+    MUST be called after whatever writes the keys and values.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeRadixSort::SortKeysAndValues()
+{
+    UintSsbo *keysIn = _pKeysBuffer;
+    UintSsbo *valuesIn = _pValuesBuffer;
+    UintSsbo *keysOut = _pTempKeysBuffer;
+    UintSsbo *valuesOut = _pTempValuesBuffer;
+
+    GLuint numWorkGroupsY = 1;
+    GLuint numWorkGroupsZ = 1;
+
+    for (unsigned int bitShift = 0; bitShift < 32; bitShift += RADIX_BITS_PER_PASS)
+    {
+        ConfigurePass(keysIn, valuesIn, keysOut, valuesOut);
+
+        glUseProgram(_histogramProgramId);
+        glUniform1ui(_unifLocHistogramBitShift, bitShift);
+        glDispatchCompute(_numWorkGroups, numWorkGroupsY, numWorkGroupsZ);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        // the scan walks through all the counts in a single work group (see prefixScan.comp)
+        glUseProgram(_scanProgramId);
+        glDispatchCompute(1, numWorkGroupsY, numWorkGroupsZ);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        glUseProgram(_scatterProgramId);
+        glUniform1ui(_unifLocScatterBitShift, bitShift);
+        glDispatchCompute(_numWorkGroups, numWorkGroupsY, numWorkGroupsZ);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        // ping pong
+        UintSsbo *swap = keysIn;
+        keysIn = keysOut;
+        keysOut = swap;
+        swap = valuesIn;
+        valuesIn = valuesOut;
+        valuesOut = swap;
+    }
+
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Points the "histogram" and "scatter" shaders' "in" and "out" buffers at the given SSBOs.
+
+    Note: Storage block bindings belong to the program, so re-binding them between dispatches 
+    is safe and doesn't disturb any other shader that uses the same buffers.
+Parameters:
+    keysIn      Read by the "histogram" and "scatter" shaders.
+    valuesIn    Read by the "scatter" shader.
+    keysOut     Written by the "scatter" shader.
+    valuesOut   Ditto
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ComputeRadixSort::ConfigurePass(UintSsbo *keysIn, UintSsbo *valuesIn, UintSsbo *keysOut, UintSsbo *valuesOut)
+{
+    keysIn->ConfigureCompute(_histogramProgramId, "SortKeysInBuffer");
+    keysIn->ConfigureCompute(_scatterProgramId, "SortKeysInBuffer");
+    valuesIn->ConfigureCompute(_scatterProgramId, "SortValuesInBuffer");
+    keysOut->ConfigureCompute(_scatterProgramId, "SortKeysOutBuffer");
+    valuesOut->ConfigureCompute(_scatterProgramId, "SortValuesOutBuffer");
+}
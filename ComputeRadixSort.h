@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+
+class UintSsbo;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Controls the compute shaders that sort a buffer of unsigned integer keys, and a buffer of 
+    unsigned integer values that go with them, on the GPU.
+
+    It is a least-significant-digit radix sort with 4 bits per digit, so it takes 8 passes for 
+    32bit keys.  Each pass is three dispatches:
+    (1) "histogram": Each work group counts how many of its keys have each of the 16 digit 
+    values.  The counts are stored digit-major (all the work groups' counts for digit 0, then 
+    all of them for digit 1, etc.).
+    (2) "scan": An exclusive prefix sum over the counts.  Because of the digit-major order, 
+    this gives each work group the spot in the output where its keys for each digit start.
+    (3) "scatter": Each key is written to its work group's start for its digit plus the number 
+    of keys before it in the same work group with the same digit.  That keeps keys with the 
+    same digit in the same order that they were in, which every pass after the first needs.
+
+    Each pass reads from one pair of buffers and writes to the other.  There are an even number 
+    of passes, so the sorted keys and values end up back in the buffers that were given.
+-----------------------------------------------------------------------------------------------*/
+class ComputeRadixSort
+{
+public:
+    ComputeRadixSort(
+        unsigned int numItems,
+        UintSsbo *keysBuffer,
+        UintSsbo *valuesBuffer,
+        const std::string &histogramComputeShaderKey,
+        const std::string &scanComputeShaderKey,
+        const std::string &scatterComputeShaderKey);
+    ~ComputeRadixSort();
+
+    void SortKeysAndValues();
+
+private:
+    void ConfigurePass(UintSsbo *keysIn, UintSsbo *valuesIn, UintSsbo *keysOut, UintSsbo *valuesOut);
+
+    unsigned int _histogramProgramId;
+    unsigned int _scanProgramId;
+    unsigned int _scatterProgramId;
+    unsigned int _numItems;
+    unsigned int _numWorkGroups;
+
+    // given to this class; not owned by it
+    UintSsbo *_pKeysBuffer;
+    UintSsbo *_pValuesBuffer;
+
+    // owned by this class
+    UintSsbo *_pTempKeysBuffer;
+    UintSsbo *_pTempValuesBuffer;
+    UintSsbo *_pDigitCountBuffer;
+
+    int _unifLocHistogramBitShift;
+    int _unifLocScatterBitShift;
+};
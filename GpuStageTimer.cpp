@@ -0,0 +1,205 @@
+#include "GpuStageTimer.h"
+
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values and generates both sets of timestamp queries.
+Parameters:
+    numStages           How many stages will be timed.  EndStage(...) takes an index less than 
+                        this.
+    framesPerAverage    How many frames to average the times over.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+GpuStageTimer::GpuStageTimer(unsigned int numStages, unsigned int framesPerAverage) :
+    _numStages(numStages),
+    _framesPerAverage(framesPerAverage),
+    _framesAccumulated(0),
+    _haveNewAverages(false),
+    _currentQuerySet(0),
+    _mostRecentQuery(0)
+{
+    _querySetIsPending[0] = false;
+    _querySetIsPending[1] = false;
+
+    unsigned int queriesPerSet = numStages + 1;
+    _queryIds.resize(queriesPerSet * 2);
+    glGenQueries(_queryIds.size(), _queryIds.data());
+
+    _stageStartQuery.resize(numStages * 2, -1);
+    _accumulatedNanoseconds.resize(numStages, 0.0);
+    _averageMilliseconds.resize(numStages, 0.0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Deletes the queries.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+GpuStageTimer::~GpuStageTimer()
+{
+    glDeleteQueries(_queryIds.size(), _queryIds.data());
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Records the timestamp that the first timed stage starts from.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void GpuStageTimer::StartFrame()
+{
+    unsigned int queryOffset = _currentQuerySet * (_numStages + 1);
+    unsigned int stageOffset = _currentQuerySet * _numStages;
+    for (unsigned int stageIndex = 0; stageIndex < _numStages; stageIndex++)
+    {
+        _stageStartQuery[stageOffset + stageIndex] = -1;
+    }
+
+    glQueryCounter(_queryIds[queryOffset], GL_TIMESTAMP);
+    _mostRecentQuery = 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Records the timestamp at the end of the given stage.  The stage is timed from the end of 
+    the stage before it (or from StartFrame()).
+
+    Note: The timestamp is taken when the GPU gets to this point in the command stream, so 
+    this MUST be called after the stage's glMemoryBarrier(...) or else the stage may still be 
+    running.
+Parameters:
+    stageIndex  Must be less than the number of stages.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void GpuStageTimer::EndStage(unsigned int stageIndex)
+{
+    if (stageIndex >= _numStages)
+    {
+        return;
+    }
+
+    unsigned int queryOffset = _currentQuerySet * (_numStages + 1);
+    unsigned int stageOffset = _currentQuerySet * _numStages;
+    _stageStartQuery[stageOffset + stageIndex] = _mostRecentQuery;
+    _mostRecentQuery = stageIndex + 1;
+    glQueryCounter(_queryIds[queryOffset + _mostRecentQuery], GL_TIMESTAMP);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Switches to the other set of queries and reads back what was issued into it last frame.  
+    Once enough frames have been read back, the averages are updated.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void GpuStageTimer::EndFrame()
+{
+    _querySetIsPending[_currentQuerySet] = true;
+    _currentQuerySet = 1 - _currentQuerySet;
+
+    _haveNewAverages = false;
+    if (!_querySetIsPending[_currentQuerySet])
+    {
+        // first frame; nothing to read yet
+        return;
+    }
+
+    ReadBackQuerySet(_currentQuerySet);
+    _querySetIsPending[_currentQuerySet] = false;
+
+    _framesAccumulated++;
+    if (_framesAccumulated >= _framesPerAverage)
+    {
+        for (unsigned int stageIndex = 0; stageIndex < _numStages; stageIndex++)
+        {
+            // nanoseconds to milliseconds
+            _averageMilliseconds[stageIndex] = _accumulatedNanoseconds[stageIndex] / (_framesAccumulated * 1000000.0);
+            _accumulatedNanoseconds[stageIndex] = 0.0;
+        }
+        _framesAccumulated = 0;
+        _haveNewAverages = true;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    True for the one frame right after the averages were updated.  Useful for only printing 
+    them when they change.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+bool GpuStageTimer::HaveNewAverages() const
+{
+    return _haveNewAverages;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the average time that the GPU spent on the given stage per frame.  
+    Frames in which the stage didn't run count as 0.
+Parameters:
+    stageIndex  Must be less than the number of stages.
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+double GpuStageTimer::StageMilliseconds(unsigned int stageIndex) const
+{
+    if (stageIndex >= _numStages)
+    {
+        return 0.0;
+    }
+
+    return _averageMilliseconds[stageIndex];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds up the average times of all stages.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+double GpuStageTimer::TotalMilliseconds() const
+{
+    double total = 0.0;
+    for (unsigned int stageIndex = 0; stageIndex < _numStages; stageIndex++)
+    {
+        total += _averageMilliseconds[stageIndex];
+    }
+
+    return total;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gets the timestamps out of the given query set and adds each stage's time to its total.
+
+    Note: GL_QUERY_RESULT waits for the result if it isn't available, but these queries were 
+    issued a frame ago, so the GPU should be long done with them.
+Parameters:
+    querySet    0 or 1.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void GpuStageTimer::ReadBackQuerySet(unsigned int querySet)
+{
+    unsigned int queryOffset = querySet * (_numStages + 1);
+    unsigned int stageOffset = querySet * _numStages;
+    for (unsigned int stageIndex = 0; stageIndex < _numStages; stageIndex++)
+    {
+        int startQuery = _stageStartQuery[stageOffset + stageIndex];
+        if (startQuery < 0)
+        {
+            // didn't run
+            continue;
+        }
+
+        GLuint64 startTime = 0;
+        GLuint64 endTime = 0;
+        glGetQueryObjectui64v(_queryIds[queryOffset + startQuery], GL_QUERY_RESULT, &startTime);
+        glGetQueryObjectui64v(_queryIds[queryOffset + stageIndex + 1], GL_QUERY_RESULT, &endTime);
+        _accumulatedNanoseconds[stageIndex] += (double)(endTime - startTime);
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Measures how long the GPU spends on each stage of a frame.  The Stopwatch can't do this 
+    because the gl*(...) calls return long before the GPU finishes the work, so this uses 
+    OpenGL timestamp queries instead.  Call StartFrame() before the first stage, EndStage(...) 
+    after each stage that runs, and EndFrame() after the last one.  A stage's time is from the 
+    end of whatever stage was timed before it (or from StartFrame()) to its own end, so a 
+    stage that doesn't run on a particular frame can just be skipped.
+
+    Reading a query's result before the GPU is done with it stalls the CPU until the GPU 
+    catches up, so there are two sets of queries.  One is issued this frame and the other, 
+    issued last frame, is read back at the end of this frame.
+
+    The results are averaged over a number of frames because a single frame's times jump 
+    around too much to compare.
+-----------------------------------------------------------------------------------------------*/
+class GpuStageTimer
+{
+public:
+    GpuStageTimer(unsigned int numStages, unsigned int framesPerAverage);
+    ~GpuStageTimer();
+
+    void StartFrame();
+    void EndStage(unsigned int stageIndex);
+    void EndFrame();
+
+    bool HaveNewAverages() const;
+    double StageMilliseconds(unsigned int stageIndex) const;
+    double TotalMilliseconds() const;
+
+private:
+    void ReadBackQuerySet(unsigned int querySet);
+
+    unsigned int _numStages;
+    unsigned int _framesPerAverage;
+    unsigned int _framesAccumulated;
+    bool _haveNewAverages;
+
+    // which of the two query sets is being issued this frame
+    unsigned int _currentQuerySet;
+    bool _querySetIsPending[2];
+
+    // per set: query 0 is the start of the frame, and query N + 1 is the end of stage N
+    std::vector<unsigned int> _queryIds;
+
+    // per set: the query that each stage started at, or -1 if the stage didn't run
+    std::vector<int> _stageStartQuery;
+    int _mostRecentQuery;
+
+    std::vector<double> _accumulatedNanoseconds;
+    std::vector<double> _averageMilliseconds;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Std430Layout.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One leaf of the Morton-ordered ("linear") quad tree.  It is a dumb container meant for use 
+    only by ParticleMortonQuadTree.
+
+    Every node of a linear quad tree is a run of particles in the Morton-sorted particle index 
+    array whose Morton codes share the same first (2 * level) bits.  So a leaf doesn't need 
+    edges, children, or neighbors.  It only needs to know which run it is.
+-----------------------------------------------------------------------------------------------*/
+struct MortonQuadTreeLeaf
+{
+    MortonQuadTreeLeaf() :
+        _mortonPrefix(0),
+        _level(0),
+        _firstParticleIndex(0),
+        _numParticles(0)
+    {
+    }
+
+    // the smallest Morton code that can be in this leaf (the shared prefix followed by 0s)
+    unsigned int _mortonPrefix;
+    unsigned int _level;
+
+    // index into the sorted particle index array, not into the particle array
+    unsigned int _firstParticleIndex;
+    unsigned int _numParticles;
+};
+
+// the members that the GPU sees, in order, with their names in GLSL (see Std430Layout.h)
+#define MORTON_QUAD_TREE_LEAF_STD430_MEMBERS(MEMBER) \
+    MEMBER(MortonQuadTreeLeaf, unsigned int, _mortonPrefix, _mortonPrefix) \
+    MEMBER(MortonQuadTreeLeaf, unsigned int, _level, _level) \
+    MEMBER(MortonQuadTreeLeaf, unsigned int, _firstParticleIndex, _firstParticleIndex) \
+    MEMBER(MortonQuadTreeLeaf, unsigned int, _numParticles, _numParticles)
+
+STD430_CHECK_LAYOUT(MortonQuadTreeLeaf, MORTON_QUAD_TREE_LEAF_STD430_MEMBERS);
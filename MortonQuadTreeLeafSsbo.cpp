@@ -0,0 +1,70 @@
+#include "MortonQuadTreeLeafSsbo.h"
+
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates space for the SSBO and dumps the given collection of leaves into it.
+Parameters:
+    leafCollection  Self-explanatory
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+MortonQuadTreeLeafSsbo::MortonQuadTreeLeafSsbo(const std::vector<MortonQuadTreeLeaf> &leafCollection) :
+    SsboBase()  // generate buffers
+{
+    // ignore _numVertices because this SSBO does not draw
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    GLuint bufferSizeBytes = sizeof(MortonQuadTreeLeaf) * leafCollection.size();
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, leafCollection.data(), GL_DYNAMIC_COPY);
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Does nothing.  Exists to be declared virtual so that the base class' destructor is called
+    upon object death.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+MortonQuadTreeLeafSsbo::~MortonQuadTreeLeafSsbo()
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Binds the SSBO object (a CPU-side thing) to its corresponding buffer in the shader (GPU).
+
+    Note: It is ok to call this function for multiple compute shaders so that the same SSBO can
+    be used in each shader.  No member variables are altered in this function.
+Parameters:
+    computeProgramId    Self-explanatory
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void MortonQuadTreeLeafSsbo::ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader)
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+
+    // see the corresponding area in ParticleSsbo::Init(...) for explanation
+    GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, bufferNameInShader.c_str());
+    glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _ssboBindingPointIndex);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId);
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The leaves do not draw.
+Parameters:
+    irrelevant
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void MortonQuadTreeLeafSsbo::ConfigureRender(unsigned int, unsigned int)
+{
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "SsboBase.h"
+#include "MortonQuadTreeLeaf.h"
+#include <vector>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the Shader Storage Block Object for the leaves of the Morton-ordered quad tree.  The 
+    leaves will be used in the compute shader only.
+-----------------------------------------------------------------------------------------------*/
+class MortonQuadTreeLeafSsbo : public SsboBase
+{
+public:
+    MortonQuadTreeLeafSsbo(const std::vector<MortonQuadTreeLeaf> &leafCollection);
+    virtual ~MortonQuadTreeLeafSsbo();
+
+    void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
+    void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+};
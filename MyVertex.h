@@ -2,6 +2,7 @@
 
 #include "glm/vec2.hpp"
 #include "glm/vec4.hpp"
+#include "Std430Layout.h"
 
 /*-----------------------------------------------------------------------------------------------
 Description:
@@ -37,3 +38,10 @@ struct MyVertex
     glm::vec4 _normal;
 };
 
+// the members that the GPU sees, in order, with their names in GLSL (see Std430Layout.h)
+#define MY_VERTEX_STD430_MEMBERS(MEMBER) \
+    MEMBER(MyVertex, glm::vec4, _position, _pos) \
+    MEMBER(MyVertex, glm::vec4, _normal, _normal)
+
+STD430_CHECK_LAYOUT(MyVertex, MY_VERTEX_STD430_MEMBERS);
+STD430_STRUCT_TYPE(MyVertex, MY_VERTEX_STD430_MEMBERS);
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "glm/vec2.hpp"
 #include "glm/vec4.hpp"
+#include "Std430Layout.h"
 
 /*-----------------------------------------------------------------------------------------------
 Description:
@@ -24,34 +26,38 @@ struct Particle
     Particle() :
         // glm structures already have "set to 0" constructors
         _collisionCountThisFrame(0),
-        _mass(0.1f),
-        _radiusOfInfluence(0.01f),
+        _speciesIndex(0),
         _indexOfNodeThatItIsOccupying(0),
-        _isActive(0)
+        _isActive(0),
+        _timeOfImpact(1.0f),
+        _framesAtRest(0)
     {
     }
 
-    // TODO: dd "previous position" too (for collision detection)
-
     // even though this is a 2D program, I wasn't able to figure out the byte misalignments 
     // between C++ and GLSL (every variable is aligned on a 16byte boundry, but adding 2-float 
     // padding to glm::vec2 didn't work and the compute shader just didn't send any particles 
     // anywhere), so I just used glm::vec4 
     // Note: Yes, I did take care of the byte offset in the vertex attrib pointer.
+    // Also Note: The layout is now checked against std430 at compile time (see the bottom of 
+    // this file), so a switch to vec2 would fail to build instead of failing silently.
     glm::vec4 _position;
     glm::vec4 _velocity;
     glm::vec4 _netForceThisFrame;
 
+    // where the particle was at the start of the last update, so that the collision shader can 
+    // tell where it went in between (see "swept collisions" in ComputeParticleQuadTreeCollisions)
+    // Note: Only X and Y.  A vec2 after the vec4s lines up without padding, and that leaves 
+    // room for the small values below without growing the record.
+    glm::vec2 _previousPosition;
+
     // used to determine color 
     // TODO: decide between this for color blending or net force
     int _collisionCountThisFrame;
 
-    // all particles have identical mass for now
-    float _mass;
-
-    // used for collision detection because a particle's position is float values, so two
-    // particles' position are almost never going to be exactly equal
-    float _radiusOfInfluence;
+    // index into the table of species, which has the mass, radius, restitution, and color that 
+    // all particles of that kind share (see ParticleSpecies)
+    unsigned int _speciesIndex;
 
     // will help improve efficiency in particle collision handling
     // Note: Rather than having each node run through its particle collection, which would leave 
@@ -64,7 +70,28 @@ struct Particle
     // (https://www.opengl.org/sdk/docs/man/html/glVertexAttribPointer.xhtml), so send the 
     // "is active" flag as an integer.  
     int _isActive; 
-    
-    // any necessary padding out to 16 bytes to match the GPU's version
-    int _padding[3];
+
+    // swept collisions only; how far through the last update (0 to 1) the particle first ran 
+    // into another particle, or 1 if it didn't, and the next update moves it back to there
+    float _timeOfImpact;
+
+    // how many updates in a row the particle has been nearly still, or PARTICLE_ASLEEP (see 
+    // particleUpdate.comp) once it has been still long enough that the update and collision 
+    // shaders leave it alone
+    unsigned int _framesAtRest;
 };
+
+// the members that the GPU sees, in order, with their names in GLSL (see Std430Layout.h)
+#define PARTICLE_STD430_MEMBERS(MEMBER) \
+    MEMBER(Particle, glm::vec4, _position, _pos) \
+    MEMBER(Particle, glm::vec4, _velocity, _vel) \
+    MEMBER(Particle, glm::vec4, _netForceThisFrame, _netForceThisFrame) \
+    MEMBER(Particle, glm::vec2, _previousPosition, _prevPos) \
+    MEMBER(Particle, int, _collisionCountThisFrame, _collisionCountThisFrame) \
+    MEMBER(Particle, unsigned int, _speciesIndex, _speciesIndex) \
+    MEMBER(Particle, unsigned int, _indexOfNodeThatItIsOccupying, _indexOfNodeThatItIsOccupying) \
+    MEMBER(Particle, int, _isActive, _isActive) \
+    MEMBER(Particle, float, _timeOfImpact, _timeOfImpact) \
+    MEMBER(Particle, unsigned int, _framesAtRest, _framesAtRest)
+
+STD430_CHECK_LAYOUT(Particle, PARTICLE_STD430_MEMBERS);
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Std430Layout.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One cell of the "cell list" version of the quad tree.  Unlike a quad tree node, a cell 
+    does not have an array of particle indices.  Instead, all the cells share one dense array 
+    of particle indices that is sorted by cell (see ComputeCellListBuild), and each cell only 
+    knows where its particles start in that array and how many there are.
+
+    The cells are laid out in the same rows and columns as the quad tree's starting nodes, so 
+    neighbors are found with row and column math instead of being stored.
+-----------------------------------------------------------------------------------------------*/
+struct ParticleCell
+{
+    ParticleCell() :
+        _firstParticleIndex(0),
+        _numParticles(0)
+    {
+    }
+
+    // index into the sorted particle index array, not into the particle array
+    unsigned int _firstParticleIndex;
+    unsigned int _numParticles;
+};
+
+// the members that the GPU sees, in order, with their names in GLSL (see Std430Layout.h)
+#define PARTICLE_CELL_STD430_MEMBERS(MEMBER) \
+    MEMBER(ParticleCell, unsigned int, _firstParticleIndex, _firstParticleIndex) \
+    MEMBER(ParticleCell, unsigned int, _numParticles, _numParticles)
+
+STD430_CHECK_LAYOUT(ParticleCell, PARTICLE_CELL_STD430_MEMBERS);
@@ -0,0 +1,70 @@
+#include "ParticleCellSsbo.h"
+
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates space for the SSBO and dumps the given collection of cells into it.
+Parameters:
+    cellCollection  Self-explanatory
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ParticleCellSsbo::ParticleCellSsbo(const std::vector<ParticleCell> &cellCollection) :
+    SsboBase()  // generate buffers
+{
+    // ignore _numVertices because this SSBO does not draw
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    GLuint bufferSizeBytes = sizeof(ParticleCell) * cellCollection.size();
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, cellCollection.data(), GL_DYNAMIC_COPY);
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Does nothing.  Exists to be declared virtual so that the base class' destructor is called
+    upon object death.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ParticleCellSsbo::~ParticleCellSsbo()
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Binds the SSBO object (a CPU-side thing) to its corresponding buffer in the shader (GPU).
+
+    Note: It is ok to call this function for multiple compute shaders so that the same SSBO can
+    be used in each shader.  No member variables are altered in this function.
+Parameters:
+    computeProgramId    Self-explanatory
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ParticleCellSsbo::ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader)
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+
+    // see the corresponding area in ParticleSsbo::Init(...) for explanation
+    GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, bufferNameInShader.c_str());
+    glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _ssboBindingPointIndex);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId);
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The cells do not draw.
+Parameters:
+    irrelevant
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ParticleCellSsbo::ConfigureRender(unsigned int, unsigned int)
+{
+}
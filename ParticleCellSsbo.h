@@ -0,0 +1,20 @@
+#pragma once
+
+#include "SsboBase.h"
+#include "ParticleCell.h"
+#include <vector>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the Shader Storage Block Object for the cells of the "cell list" quad tree.  The 
+    cells will be used in the compute shader only.
+-----------------------------------------------------------------------------------------------*/
+class ParticleCellSsbo : public SsboBase
+{
+public:
+    ParticleCellSsbo(const std::vector<ParticleCell> &cellCollection);
+    virtual ~ParticleCellSsbo();
+
+    void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
+    void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+};
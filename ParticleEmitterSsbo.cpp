@@ -0,0 +1,116 @@
+#include "ParticleEmitterSsbo.h"
+
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates space for the SSBO and fills it with emitters that emit nothing.
+Parameters:
+    maxEmitters     Self-explanatory
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ParticleEmitterSsbo::ParticleEmitterSsbo(unsigned int maxEmitters) :
+    SsboBase(),  // generate buffers
+    _maxEmitters(maxEmitters)
+{
+    // ignore _numVertices because this SSBO does not draw
+
+    std::vector<ParticleEmitterTableEntry> emptyEmitters(maxEmitters);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    GLuint bufferSizeBytes = sizeof(ParticleEmitterTableEntry) * maxEmitters;
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, emptyEmitters.data(), GL_DYNAMIC_DRAW);
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Does nothing.  Exists to be declared virtual so that the base class' destructor is called
+    upon object death.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ParticleEmitterSsbo::~ParticleEmitterSsbo()
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Binds the SSBO object (a CPU-side thing) to its corresponding buffer in the shader (GPU).
+
+    Note: It is ok to call this function for multiple compute shaders so that the same SSBO can
+    be used in each shader.  No member variables are altered in this function.
+Parameters:
+    computeProgramId    Self-explanatory
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ParticleEmitterSsbo::ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader)
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+
+    // see the corresponding area in ParticleSsbo::Init(...) for explanation
+    GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, bufferNameInShader.c_str());
+    glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _ssboBindingPointIndex);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId);
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Emitters don't draw, so this does nothing.
+Parameters:
+    renderProgramId     Ignored.
+    drawStyle           Ignored.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ParticleEmitterSsbo::ConfigureRender(unsigned int, unsigned int)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Writes the given emitters over the start of the table.  Anything after them is left 
+    alone; the shader is told how many emitters to look at.
+Parameters:
+    emitterCollection   Self-explanatory
+Returns:
+    False if there are more emitters than the table has room for (nothing is written), 
+    otherwise true.
+-----------------------------------------------------------------------------------------------*/
+bool ParticleEmitterSsbo::UpdateEmitters(const std::vector<ParticleEmitterTableEntry> &emitterCollection)
+{
+    if (emitterCollection.size() > _maxEmitters)
+    {
+        return false;
+    }
+
+    if (emitterCollection.empty())
+    {
+        return true;
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    GLuint bufferSizeBytes = sizeof(ParticleEmitterTableEntry) * emitterCollection.size();
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, bufferSizeBytes, emitterCollection.data());
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for how many emitters the table has room for.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleEmitterSsbo::MaxEmitters() const
+{
+    return _maxEmitters;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "SsboBase.h"
+#include "ParticleEmitterTableEntry.h"
+#include <vector>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the Shader Storage Block Object for the table of particle emitters that the 
+    "particle reset" shader reads.  Room for a fixed number of emitters is allocated up front, 
+    and the table is written on the CPU side whenever the emitters change (see 
+    ComputeParticleReset).
+-----------------------------------------------------------------------------------------------*/
+class ParticleEmitterSsbo : public SsboBase
+{
+public:
+    ParticleEmitterSsbo(unsigned int maxEmitters);
+    virtual ~ParticleEmitterSsbo();
+
+    void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
+    void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+
+    bool UpdateEmitters(const std::vector<ParticleEmitterTableEntry> &emitterCollection);
+    unsigned int MaxEmitters() const;
+
+private:
+    unsigned int _maxEmitters;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "glm/vec4.hpp"
+#include "Std430Layout.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One emitter in the table that the "particle reset" shader reads (see ParticleEmitterSsbo 
+    and ComputeParticleReset).  The shader has no concept of inheritance, so point and bar 
+    emitters share one structure and a flag tells them apart.
+
+    The emitters' particles are handed out one per shader invocation.  Each emitter's 
+    invocations start at the total of the emitters before it (a prefix sum over the table), so 
+    an invocation finds its emitter with a binary search.
+-----------------------------------------------------------------------------------------------*/
+struct ParticleEmitterTableEntry
+{
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        Sets initial values.  An emitter that emits nothing.
+    Parameters: None
+    Returns:    None
+    -------------------------------------------------------------------------------------------*/
+    ParticleEmitterTableEntry() :
+        _p1(0.0f, 0.0f, 0.0f, 1.0f),
+        _p2(0.0f, 0.0f, 0.0f, 1.0f),
+        _emitDir(0.0f, 0.0f, 0.0f, 0.0f),
+        _minVelocity(0.0f),
+        _deltaVelocity(0.0f),
+        _isPointEmitter(0),
+        _firstEmitIndex(0),
+        _numToEmit(0)
+    {
+        _padding[0] = 0;
+        _padding[1] = 0;
+        _padding[2] = 0;
+    }
+
+    // point emitter: the center
+    // bar emitter: the start of the bar
+    glm::vec4 _p1;
+
+    // bar emitter only: the end of the bar
+    glm::vec4 _p2;
+
+    // bar emitter only (point emitters emit in every direction)
+    glm::vec4 _emitDir;
+
+    float _minVelocity;
+    float _deltaVelocity;
+    unsigned int _isPointEmitter;
+
+    // where this emitter's invocations start, and how many there are
+    unsigned int _firstEmitIndex;
+    unsigned int _numToEmit;
+
+    // std430 pads the structure out to a multiple of its vec4 alignment
+    int _padding[3];
+};
+
+// the members that the GPU sees, in order, with their names in GLSL (see Std430Layout.h)
+#define PARTICLE_EMITTER_TABLE_ENTRY_STD430_MEMBERS(MEMBER) \
+    MEMBER(ParticleEmitterTableEntry, glm::vec4, _p1, _p1) \
+    MEMBER(ParticleEmitterTableEntry, glm::vec4, _p2, _p2) \
+    MEMBER(ParticleEmitterTableEntry, glm::vec4, _emitDir, _emitDir) \
+    MEMBER(ParticleEmitterTableEntry, float, _minVelocity, _minVelocity) \
+    MEMBER(ParticleEmitterTableEntry, float, _deltaVelocity, _deltaVelocity) \
+    MEMBER(ParticleEmitterTableEntry, unsigned int, _isPointEmitter, _isPointEmitter) \
+    MEMBER(ParticleEmitterTableEntry, unsigned int, _firstEmitIndex, _firstEmitIndex) \
+    MEMBER(ParticleEmitterTableEntry, unsigned int, _numToEmit, _numToEmit)
+
+STD430_CHECK_LAYOUT(ParticleEmitterTableEntry, PARTICLE_EMITTER_TABLE_ENTRY_STD430_MEMBERS);
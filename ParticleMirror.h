@@ -0,0 +1,39 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+#include "Std430Layout.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The compact copy of each particle that the collision shader's broadphase reads instead of 
+    the full particle (see ComputeParticleQuadTreeCollisions::SetParticleMirror(...)).  Only 
+    the GPU ever writes these.  The C++ version is here so that the GLSL version can be 
+    generated from it and so that the buffer can be sized from it.
+-----------------------------------------------------------------------------------------------*/
+struct ParticleMirror
+{
+    ParticleMirror() :
+        _pos(0.0f, 0.0f),
+        _vel(0.0f, 0.0f),
+        _radiusAndMass(0),
+        _isAsleep(0)
+    {
+    }
+
+    // X and Y only; this is a 2D demo
+    glm::vec2 _pos;
+    glm::vec2 _vel;
+
+    // the species' radius and mass packed as two halves (packHalf2x16(...))
+    unsigned int _radiusAndMass;
+    unsigned int _isAsleep;
+};
+
+// the members that the GPU sees, in order, with their names in GLSL (see Std430Layout.h)
+#define PARTICLE_MIRROR_STD430_MEMBERS(MEMBER) \
+    MEMBER(ParticleMirror, glm::vec2, _pos, _pos) \
+    MEMBER(ParticleMirror, glm::vec2, _vel, _vel) \
+    MEMBER(ParticleMirror, unsigned int, _radiusAndMass, _radiusAndMass) \
+    MEMBER(ParticleMirror, unsigned int, _isAsleep, _isAsleep)
+
+STD430_CHECK_LAYOUT(ParticleMirror, PARTICLE_MIRROR_STD430_MEMBERS);
@@ -0,0 +1,35 @@
+#include "ParticleMortonQuadTree.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Figures out the deepest level of the Morton quad tree whose nodes are still at least as 
+    wide as the distance at which two particles collide (2 radii).  Each particle records its 
+    node at this level so that the particle reorder can put particles that could collide next 
+    to each other.  The collision shader walks the leaves instead (see 
+    ParticleCollisionsWithMortonLeaves(...) in quadTreeParticleCollisions.comp).
+
+    The particle region is a square that is 2 * radius wide, and each level halves it.
+
+    Note: Level 0 is the whole particle region, which would make the collision shader check 
+    every particle against every other particle, and the Morton math in the shaders needs at 
+    least one level of bits to shift, so the smallest level that is returned is 1.
+Parameters:
+    particleRegionRadius        Self-explanatory
+    particleRadiusOfInfluence   Self-explanatory
+Returns:
+    A level on the range [1, _MAX_LEVELS].
+Exception:  Safe
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleMortonQuadTree::CollisionLevel(float particleRegionRadius, float particleRadiusOfInfluence)
+{
+    float collisionDistance = 2.0f * particleRadiusOfInfluence;
+    float nodeWidth = 2.0f * particleRegionRadius;
+    unsigned int level = 0;
+    while (level < _MAX_LEVELS && (nodeWidth * 0.5f) >= collisionDistance)
+    {
+        nodeWidth *= 0.5f;
+        level++;
+    }
+
+    return (level == 0) ? 1 : level;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The constants and setup math for the Morton-ordered ("linear") quad tree.  This is the 
+    second spatial structure next to ParticleQuadTree, and like that one it is only used as 
+    setup before the compute shaders take over (see ComputeMortonQuadTreeBuild).
+
+    Every particle gets a 32bit Morton code by turning its position in the particle region into 
+    a pair of 16bit integer coordinates and interleaving their bits (Y in the odd bits, X in the 
+    even bits).  Sorting the particles by code puts them in Z order, and then every quad tree 
+    node at every level is a contiguous run of the sorted particles:
+    - Level 0 is the whole particle region.  
+    - A node at level L is a run whose codes share the same first (2 * L) bits.  
+    - Its 4 children are the runs where the next 2 bits are 00, 01, 10, and 11.  
+    So the tree doesn't need to be built node by node.  It falls out of the sorted codes.  A 
+    node becomes a leaf as soon as it holds few enough particles, so the tree is only deep 
+    where the particles are dense, and it never needs a pre-allocated pool of nodes like 
+    ParticleQuadTree.
+-----------------------------------------------------------------------------------------------*/
+class ParticleMortonQuadTree
+{
+public:
+    static unsigned int CollisionLevel(float particleRegionRadius, float particleRadiusOfInfluence);
+
+    // 16 bits per axis, 2 bits per level
+    static const unsigned int _MAX_LEVELS = 16;
+
+    // a node with this many particles or fewer is a leaf
+    static const unsigned int _MAX_PARTICLES_PER_LEAF = 32;
+
+    // inactive particles get this code so that they sort to the end
+    // Note: MUST match the value in the Morton quad tree compute shaders.
+    static const unsigned int _INACTIVE_MORTON_CODE = 0xffffffff;
+};
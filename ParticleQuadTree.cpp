@@ -1,22 +1,76 @@
 #include "ParticleQuadTree.h"
 
+#include <math.h>
+
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Sets up the initial tree subdivision with _NUM_ROWS_IN_TREE_INITIAL by 
-    _NUM_COLUMNS_IN_TREE_INITIAL nodes.  Boundaries are determined by the particle region center 
+    Picks how many rows and columns of starting nodes to split the particle region into.  The 
+    grid is square, so this is both the number of rows and the number of columns.
+
+    A starting node is aimed at 2 radii wide, which is the distance at which two particles 
+    collide.  Any bigger and the nodes pick up particles that are too far away to matter.  It 
+    can't be any smaller: the cell list and the tiled cell list collisions use this grid and 
+    only ever look at a 3x3 block of cells, which only covers every particle that could be 
+    touching if a cell is at least as wide as two particles' radii.  So the particle count can't push the grid finer than that.  Crowded 
+    nodes are left to subdivision instead, which stops at the same width (see main).
+
+    It is also limited on the other side: no more starting nodes than particles, which would 
+    just be empty nodes to walk through.
+
+    Note: The starting nodes used to be hard-coded at 64x64, which was only right for one 
+    radius and one particle count.
+Parameters:
+    particleRegionRadius        Self-explanatory
+    particleRadiusOfInfluence   Self-explanatory
+    maxParticles                Self-explanatory
+Returns:
+    The number of rows (and columns) in the starting grid, at least 1.
+Exception:  Safe
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleQuadTree::StartingGridResolution(float particleRegionRadius, 
+    float particleRadiusOfInfluence, unsigned int maxParticles)
+{
+    // the finest that the 3x3 neighborhoods allow (see Description)
+    float regionWidth = 2.0f * particleRegionRadius;
+    unsigned int resolution = (unsigned int)(regionWidth / (2.0f * particleRadiusOfInfluence));
+
+    unsigned int resolutionForParticles = (unsigned int)sqrtf((float)maxParticles);
+    if (resolution > resolutionForParticles)
+    {
+        resolution = resolutionForParticles;
+    }
+
+    return (resolution == 0) ? 1 : resolution;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the initial tree subdivision with numRowsInTreeInitial by 
+    numColumnsInTreeInitial nodes, and room for _MAX_NODES_PER_STARTING_NODE times that many 
+    nodes in total.  Boundaries are determined by the particle region center 
     and the particle region radius.  The ParticleUpdater should constrain particles to this 
     region, and the quad tree will subdivide within this region.
 Parameters:
     particleRegionCenter    In world space
     particleRegionRadius    In world space
+    numColumnsInTreeInitial See StartingGridResolution(...).
+    numRowsInTreeInitial    Ditto
 Returns:    None
 Exception:  Safe
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-ParticleQuadTree::ParticleQuadTree(const glm::vec4 &particleRegionCenter, float particleRegionRadius)
+ParticleQuadTree::ParticleQuadTree(const glm::vec4 &particleRegionCenter, float particleRegionRadius, 
+    unsigned int numColumnsInTreeInitial, unsigned int numRowsInTreeInitial)
 {
+    _numColumnsInTreeInitial = numColumnsInTreeInitial;
+    _numRowsInTreeInitial = numRowsInTreeInitial;
+    _numStartingNodes = numColumnsInTreeInitial * numRowsInTreeInitial;
+    _maxNodes = _numStartingNodes * _MAX_NODES_PER_STARTING_NODE;
+
     // allocate space for the nodes
-    _allQuadTreeNodes.resize(_MAX_NODES);
+    _allNodeBounds.resize(_maxNodes);
+    _allNodeNeighbors.resize(_maxNodes);
+    _allNodeCounts.resize(_maxNodes);
 
     _particleRegionCenter = particleRegionCenter;
     _particleRegionRadius = particleRegionRadius;
@@ -28,82 +82,85 @@ ParticleQuadTree::ParticleQuadTree(const glm::vec4 &particleRegionCenter, float
     float xBegin = particleRegionCenter.x - particleRegionRadius;
     float yBegin = particleRegionCenter.y + particleRegionRadius;
 
-    float xIncrementPerNode = 2.0f * particleRegionRadius / _NUM_COLUMNS_IN_TREE_INITIAL;
-    float yIncrementPerNode = 2.0f * particleRegionRadius / _NUM_ROWS_IN_TREE_INITIAL;
+    float xIncrementPerNode = 2.0f * particleRegionRadius / _numColumnsInTreeInitial;
+    float yIncrementPerNode = 2.0f * particleRegionRadius / _numRowsInTreeInitial;
 
     float y = yBegin;
-    for (int row = 0; row < _NUM_ROWS_IN_TREE_INITIAL; row++)
+    for (unsigned int row = 0; row < _numRowsInTreeInitial; row++)
     {
         float x = xBegin;
-        for (int column = 0; column < _NUM_COLUMNS_IN_TREE_INITIAL; column++)
+        for (unsigned int column = 0; column < _numColumnsInTreeInitial; column++)
         {
-            int nodeIndex = (row * _NUM_COLUMNS_IN_TREE_INITIAL) + column;
-            ParticleQuadTreeNode &node = _allQuadTreeNodes[nodeIndex];
-            node._inUse = true;
+            unsigned int nodeIndex = (row * _numColumnsInTreeInitial) + column;
+            _allNodeCounts[nodeIndex]._inUse = true;
 
             // set the borders of the node
-            node._leftEdge = x;
-            node._rightEdge = x + xIncrementPerNode;
-            node._topEdge = y;
-            node._bottomEdge = y - yIncrementPerNode;
+            ParticleQuadTreeNodeBounds &bounds = _allNodeBounds[nodeIndex];
+            bounds._leftEdge = x;
+            bounds._rightEdge = x + xIncrementPerNode;
+            bounds._topEdge = y;
+            bounds._bottomEdge = y - yIncrementPerNode;
 
             // assign neighbors
             // Note: Nodes on the edge of the initial tree have three null neighbors.  There may 
             // be other ways to calculate these, but I chose the following because it is spelled 
             // out verbosely.
             // Ex: a top - row node has null top left, top, and top right neighbors.
+            // Also Note: The neighbors start out null (ParticleQuadTreeNodeNeighbors::_NO_NEIGHBOR), 
+            // so only the ones that exist are set.
+            ParticleQuadTreeNodeNeighbors &neighbors = _allNodeNeighbors[nodeIndex];
 
             // left edge does not have a "left" neighbor
             if (column > 0)
             {
-                node._neighborIndexLeft = nodeIndex - 1;
+                neighbors._neighborIndexLeft = nodeIndex - 1;
             }
 
             // left and top edges do not have a "top left" neighbor
             if (row > 0 && column > 0)
             {
                 // "top left" neighbor = current node - 1 row - 1 column
-                node._neighborIndexTopLeft = nodeIndex - _NUM_COLUMNS_IN_TREE_INITIAL - 1;
+                neighbors._neighborIndexTopLeft = nodeIndex - _numColumnsInTreeInitial - 1;
             }
 
             // top row does not have a "top" neighbor
             if (row > 0)
             {
-                node._neighborIndexTop = nodeIndex - _NUM_COLUMNS_IN_TREE_INITIAL;
+                neighbors._neighborIndexTop = nodeIndex - _numColumnsInTreeInitial;
             }
 
             // right and top edges do not have a "top right" neighbor
-            if (row > 0 && column < (_NUM_COLUMNS_IN_TREE_INITIAL - 1))
+            if (row > 0 && column < (_numColumnsInTreeInitial - 1))
             {
                 // "top right" neighbor = current node - 1 row + 1 column
-                node._neighborIndexTopRight = nodeIndex - _NUM_COLUMNS_IN_TREE_INITIAL + 1;
+                neighbors._neighborIndexTopRight = nodeIndex - _numColumnsInTreeInitial + 1;
             }
 
             // right edge does not have a "right" neighbor
-            if (column < (_NUM_COLUMNS_IN_TREE_INITIAL - 1))
+            if (column < (_numColumnsInTreeInitial - 1))
             {
-                node._neighborIndexRight = nodeIndex + 1;
+                neighbors._neighborIndexRight = nodeIndex + 1;
             }
 
             // right and bottom edges do not have a "bottom right" neighbor
-            if (row < (_NUM_ROWS_IN_TREE_INITIAL - 1) &&
-                column < (_NUM_COLUMNS_IN_TREE_INITIAL - 1))
+            if (row < (_numRowsInTreeInitial - 1) &&
+                column < (_numColumnsInTreeInitial - 1))
             {
                 // "bottom right" neighbor = current node + 1 row + 1 column
-                node._neighborIndexBottomRight = nodeIndex + _NUM_COLUMNS_IN_TREE_INITIAL + 1;
+                neighbors._neighborIndexBottomRight = nodeIndex + _numColumnsInTreeInitial + 1;
             }
 
             // bottom edge does not have a "bottom" neighbor
-            if (row < (_NUM_ROWS_IN_TREE_INITIAL - 1))
+            if (row < (_numRowsInTreeInitial - 1))
             {
-                node._neighborIndexBottom = nodeIndex + _NUM_COLUMNS_IN_TREE_INITIAL;
+                neighbors._neighborIndexBottom = nodeIndex + _numColumnsInTreeInitial;
             }
 
             // left and bottom edges do not have a "bottom left" neighbor
-            if (row < (_NUM_ROWS_IN_TREE_INITIAL - 1) && column > 0)
+            if (row < (_numRowsInTreeInitial - 1) && column > 0)
             {
                 // bottom left neighbor = current node + 1 row - 1 column
-                node._neighborIndexBottomLeft = nodeIndex + _NUM_COLUMNS_IN_TREE_INITIAL - 1;
+                neighbors._neighborIndexBottomLeft = nodeIndex + _numColumnsInTreeInitial - 1;
             }
 
 
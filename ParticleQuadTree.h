@@ -9,7 +9,7 @@ Description:
     Starts up the quad tree that will contain the particles.  The constructor initializes the 
     values for all the nodes, in particular calculating each node's edges and neighbors.  After 
     that, it is a dumb structure.  It is meant to be used as setup before uploading the quad 
-    tree into an SSBO.
+    tree into its SSBOs.
     
     Note: I considered and heavily entertained the idea of starting every frame with one node
     and subdividing as necessary, but I abandoned that idea because there will be many particles
@@ -20,23 +20,40 @@ Creator:    John Cox (1-10-2017)
 class ParticleQuadTree
 {
 public:
-    ParticleQuadTree(const glm::vec4 &particleRegionCenter, float particleRegionRadius);
+    static unsigned int StartingGridResolution(float particleRegionRadius, 
+        float particleRadiusOfInfluence, unsigned int maxParticles);
+
+    ParticleQuadTree(const glm::vec4 &particleRegionCenter, float particleRegionRadius, 
+        unsigned int numColumnsInTreeInitial, unsigned int numRowsInTreeInitial);
 
     // increase the number of additional nodes as necessary to handle more subdivision
     // Note: This algorithm was built with the compute shader's implementation in mind.  These 
     // structures are meant to be used as if a compute shader was running it, hence all the 
     // arrays and a complete lack of runtime memory reallocation.
-    //static const int _NUM_ROWS_IN_TREE_INITIAL = 8;
-    //static const int _NUM_COLUMNS_IN_TREE_INITIAL = 8;
-    //static const int _NUM_STARTING_NODES = _NUM_ROWS_IN_TREE_INITIAL * _NUM_COLUMNS_IN_TREE_INITIAL;
-    static const int _NUM_ROWS_IN_TREE_INITIAL = 64;
-    static const int _NUM_COLUMNS_IN_TREE_INITIAL = 64;
-    static const int _NUM_STARTING_NODES = _NUM_ROWS_IN_TREE_INITIAL * _NUM_COLUMNS_IN_TREE_INITIAL;
+    static const unsigned int _MAX_NODES_PER_STARTING_NODE = 8;
+
+    // every leaf gets a list of the leaves that touch it (see ComputeQuadTreeLeafNeighbors)
+    // Note: A leaf that is 2 levels bigger than its smallest neighbors has 4 * 4 side 
+    // neighbors plus 4 corners, so this is room for that with some to spare.  A leaf with more 
+    // than this falls back to walking the tree during collisions.
+    // Also Note: If you change this, MUST also change the value in 
+    // quadTreeLeafNeighbors.comp and quadTreeParticleCollisions.comp.
+    static const int _MAX_LEAF_NEIGHBORS = 31;
+    static const int _LEAF_NEIGHBOR_STRIDE = _MAX_LEAF_NEIGHBORS + 1;
+
+    // the nodes, split up by how they are used (see ParticleQuadTreeNode.h)
+    // Note: The particle indices are not set up on the CPU.  They are filled in by the 
+    // "populate" shader every frame.
+    std::vector<ParticleQuadTreeNodeBounds> _allNodeBounds;
+    std::vector<ParticleQuadTreeNodeNeighbors> _allNodeNeighbors;
+    std::vector<ParticleQuadTreeNodeCounts> _allNodeCounts;
 
-    // if you change this, MUST also change the array size of atomic counters in quadTreePopulate.comp
-    static const int _MAX_NODES = _NUM_STARTING_NODES * 8;
+    // set at startup (see StartingGridResolution(...)) and constant after that
+    unsigned int _numColumnsInTreeInitial;
+    unsigned int _numRowsInTreeInitial;
+    unsigned int _numStartingNodes;
+    unsigned int _maxNodes;
 
-    std::vector<ParticleQuadTreeNode> _allQuadTreeNodes;
     glm::vec4 _particleRegionCenter;
     float _particleRegionRadius;
 
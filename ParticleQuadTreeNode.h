@@ -1,71 +1,146 @@
 #pragma once
 
-#include <memory>
+#include "Std430Layout.h"
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Contains all info necessary for a single node of the quad tree.  It is a dumb container 
-    meant for use only by ParticleQuadTree.
+    The info for a single node of the quad tree is split up by how it is used.  Each part lives
+    in its own SSBO, and a node's index is the same in all of them.  The indices of the
+    particles that the node contains are the fourth part, but that is just an array of unsigned
+    integers (MAX_PARTICLES_PER_QUAD_TREE_NODE per node, see UintSsbo), so there is no
+    structure for it.
+
+    This used to be one big structure, but the particle indices made up ~85% of it, and most of
+    the compute shaders never look at them.  A shader that only wanted a node's edges or its
+    count still pulled in cache lines full of the indices around them.  Now each shader
+    declares only the buffers that it uses.
+
+    These are dumb containers meant for use only by ParticleQuadTree.
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-struct ParticleQuadTreeNode
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The node's edges.  These are set once (on the CPU for the starting nodes, or during
+    subdivision for child nodes) and only read after that.
+-----------------------------------------------------------------------------------------------*/
+struct ParticleQuadTreeNodeBounds
+{
+    ParticleQuadTreeNodeBounds() :
+        _leftEdge(0.0f),
+        _topEdge(0.0f),
+        _rightEdge(0.0f),
+        _bottomEdge(0.0f)
+    {
+    }
+
+    // left and right edges implicitly X, top and bottom implicitly Y
+    float _leftEdge;
+    float _topEdge;
+    float _rightEdge;
+    float _bottomEdge;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The node's 8 neighbors.  Like the bounds, these are set once and only read after that.
+
+    A starting node on the edge of the tree has no neighbor on that side, and that neighbor is 
+    _NO_NEIGHBOR.  0 is a real node, so it can't be used as "null".
+-----------------------------------------------------------------------------------------------*/
+struct ParticleQuadTreeNodeNeighbors
 {
-    ParticleQuadTreeNode() :
+    ParticleQuadTreeNodeNeighbors() :
+        _neighborIndexLeft(_NO_NEIGHBOR),
+        _neighborIndexTopLeft(_NO_NEIGHBOR),
+        _neighborIndexTop(_NO_NEIGHBOR),
+        _neighborIndexTopRight(_NO_NEIGHBOR),
+        _neighborIndexRight(_NO_NEIGHBOR),
+        _neighborIndexBottomRight(_NO_NEIGHBOR),
+        _neighborIndexBottom(_NO_NEIGHBOR),
+        _neighborIndexBottomLeft(_NO_NEIGHBOR)
+    {
+    }
+
+    // Note: MUST match the value in quadTreeLeafNeighbors.comp and quadTreeParticleCollisions.comp.
+    static const unsigned int _NO_NEIGHBOR = 0xffffffff;
+
+    // while not technically necessary because the indices are generated on the CPU side and do
+    // not touch an atomic counter in any compute shader, I changed them to unsigned to match
+    // the child node indices (standardizing my indices)
+    unsigned int _neighborIndexLeft;
+    unsigned int _neighborIndexTopLeft;
+    unsigned int _neighborIndexTop;
+    unsigned int _neighborIndexTopRight;
+    unsigned int _neighborIndexRight;
+    unsigned int _neighborIndexBottomRight;
+    unsigned int _neighborIndexBottom;
+    unsigned int _neighborIndexBottomLeft;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The node's particle count along with the things that are always looked at alongside it:
+    whether the node is in use, whether it was subdivided, and if so, where its children are.
+    These change every frame and are read by every shader that walks the tree, so they are kept
+    together and small (28 bytes).
+-----------------------------------------------------------------------------------------------*/
+struct ParticleQuadTreeNodeCounts
+{
+    ParticleQuadTreeNodeCounts() :
         _numCurrentParticles(0),
         _inUse(0),
         _isSubdivided(0),
         _childNodeIndexTopLeft(0),
         _childNodeIndexTopRight(0),
         _childNodeIndexBottomRight(0),
-        _childNodeIndexBottomLeft(0),
-        _leftEdge(0.0f),
-        _topEdge(0.0f),
-        _rightEdge(0.0f),
-        _bottomEdge(0.0f),
-        _neighborIndexLeft(0),
-        _neighborIndexTopLeft(0),
-        _neighborIndexTop(0),
-        _neighborIndexTopRight(0),
-        _neighborIndexRight(0),
-        _neighborIndexBottomRight(0),
-        _neighborIndexBottom(0),
-        _neighborIndexBottomLeft(0)
+        _childNodeIndexBottomLeft(0)
     {
-        memset(_indicesForContainedParticles, 0, sizeof(int) * MAX_PARTICLES_PER_QUAD_TREE_NODE);
     }
 
+    // the size of each node's section of the particle index buffer
     static const unsigned int MAX_PARTICLES_PER_QUAD_TREE_NODE = 100;
 
-    unsigned int _indicesForContainedParticles[MAX_PARTICLES_PER_QUAD_TREE_NODE];
     unsigned int _numCurrentParticles;
 
     int _inUse;
     int _isSubdivided;
 
-    // changed from "int" in the CPU version to "unsigned int" in the GPU version because atomic 
-    // counters can only be unsigned integers and the compiler will throw an error rather than 
+    // changed from "int" in the CPU version to "unsigned int" in the GPU version because atomic
+    // counters can only be unsigned integers and the compiler will throw an error rather than
     // cast a signed to an unsigned
     unsigned int _childNodeIndexTopLeft;
     unsigned int _childNodeIndexTopRight;
     unsigned int _childNodeIndexBottomRight;
     unsigned int _childNodeIndexBottomLeft;
+};
 
-    // left and right edges implicitly X, top and bottom implicitly Y
-    float _leftEdge;
-    float _topEdge;
-    float _rightEdge;
-    float _bottomEdge;
+// the members that the GPU sees, in order, with their names in GLSL (see Std430Layout.h)
+#define PARTICLE_QUAD_TREE_NODE_BOUNDS_STD430_MEMBERS(MEMBER) \
+    MEMBER(ParticleQuadTreeNodeBounds, float, _leftEdge, _leftEdge) \
+    MEMBER(ParticleQuadTreeNodeBounds, float, _topEdge, _topEdge) \
+    MEMBER(ParticleQuadTreeNodeBounds, float, _rightEdge, _rightEdge) \
+    MEMBER(ParticleQuadTreeNodeBounds, float, _bottomEdge, _bottomEdge)
 
-    // while not technically necessary because the indices are generated on the CPU side and do 
-    // not touch an atomic counter in any compute shader, I changed them to unsigned to match 
-    // the child node indices (standardizing my indices)
-    unsigned int _neighborIndexLeft;
-    unsigned int _neighborIndexTopLeft;
-    unsigned int _neighborIndexTop;
-    unsigned int _neighborIndexTopRight;
-    unsigned int _neighborIndexRight;
-    unsigned int _neighborIndexBottomRight;
-    unsigned int _neighborIndexBottom;
-    unsigned int _neighborIndexBottomLeft;
+#define PARTICLE_QUAD_TREE_NODE_NEIGHBORS_STD430_MEMBERS(MEMBER) \
+    MEMBER(ParticleQuadTreeNodeNeighbors, unsigned int, _neighborIndexLeft, _neighborIndexLeft) \
+    MEMBER(ParticleQuadTreeNodeNeighbors, unsigned int, _neighborIndexTopLeft, _neighborIndexTopLeft) \
+    MEMBER(ParticleQuadTreeNodeNeighbors, unsigned int, _neighborIndexTop, _neighborIndexTop) \
+    MEMBER(ParticleQuadTreeNodeNeighbors, unsigned int, _neighborIndexTopRight, _neighborIndexTopRight) \
+    MEMBER(ParticleQuadTreeNodeNeighbors, unsigned int, _neighborIndexRight, _neighborIndexRight) \
+    MEMBER(ParticleQuadTreeNodeNeighbors, unsigned int, _neighborIndexBottomRight, _neighborIndexBottomRight) \
+    MEMBER(ParticleQuadTreeNodeNeighbors, unsigned int, _neighborIndexBottom, _neighborIndexBottom) \
+    MEMBER(ParticleQuadTreeNodeNeighbors, unsigned int, _neighborIndexBottomLeft, _neighborIndexBottomLeft)
 
-};
+#define PARTICLE_QUAD_TREE_NODE_COUNTS_STD430_MEMBERS(MEMBER) \
+    MEMBER(ParticleQuadTreeNodeCounts, unsigned int, _numCurrentParticles, _numCurrentParticles) \
+    MEMBER(ParticleQuadTreeNodeCounts, int, _inUse, _inUse) \
+    MEMBER(ParticleQuadTreeNodeCounts, int, _isSubdivided, _isSubdivided) \
+    MEMBER(ParticleQuadTreeNodeCounts, unsigned int, _childNodeIndexTopLeft, _childNodeIndexTopLeft) \
+    MEMBER(ParticleQuadTreeNodeCounts, unsigned int, _childNodeIndexTopRight, _childNodeIndexTopRight) \
+    MEMBER(ParticleQuadTreeNodeCounts, unsigned int, _childNodeIndexBottomRight, _childNodeIndexBottomRight) \
+    MEMBER(ParticleQuadTreeNodeCounts, unsigned int, _childNodeIndexBottomLeft, _childNodeIndexBottomLeft)
+
+STD430_CHECK_LAYOUT(ParticleQuadTreeNodeBounds, PARTICLE_QUAD_TREE_NODE_BOUNDS_STD430_MEMBERS);
+STD430_CHECK_LAYOUT(ParticleQuadTreeNodeNeighbors, PARTICLE_QUAD_TREE_NODE_NEIGHBORS_STD430_MEMBERS);
+STD430_CHECK_LAYOUT(ParticleQuadTreeNodeCounts, PARTICLE_QUAD_TREE_NODE_COUNTS_STD430_MEMBERS);
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "glm/vec4.hpp"
+#include "Std430Layout.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The properties that are shared by every particle of one kind.  Each particle only stores 
+    the index of its species (see Particle::_speciesIndex), and the shaders look the rest up in 
+    a small table of these (see ParticleSpeciesSsbo).  Particles of one species are identical 
+    in everything but where they are and where they are going, so there is no need for each 
+    one to carry its own copy.
+-----------------------------------------------------------------------------------------------*/
+struct ParticleSpecies
+{
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        Sets initial values.  The defaults are what every particle used to have on its own.
+    Parameters: None
+    Returns:    None
+    -------------------------------------------------------------------------------------------*/
+    ParticleSpecies() :
+        _mass(0.1f),
+        _radiusOfInfluence(0.01f),
+        _restitution(1.0f),
+        _padding(0.0f),
+        _color(1.0f, 1.0f, 1.0f, 1.0f)
+    {
+    }
+
+    float _mass;
+
+    // used for collision detection because a particle's position is float values, so two
+    // particles' position are almost never going to be exactly equal
+    float _radiusOfInfluence;
+
+    // 1 is a perfectly elastic collision, 0 means that the particles stop moving towards each 
+    // other and don't bounce apart
+    // Note: When two species collide, the bouncier of the two is used.
+    float _restitution;
+
+    // the color is a vec4, which std430 aligns on 16 bytes
+    float _padding;
+
+    // multiplied with the "collision count" color in the render shader, so white leaves it alone
+    glm::vec4 _color;
+};
+
+// the members that the GPU sees, in order, with their names in GLSL (see Std430Layout.h)
+#define PARTICLE_SPECIES_STD430_MEMBERS(MEMBER) \
+    MEMBER(ParticleSpecies, float, _mass, _mass) \
+    MEMBER(ParticleSpecies, float, _radiusOfInfluence, _radiusOfInfluence) \
+    MEMBER(ParticleSpecies, float, _restitution, _restitution) \
+    MEMBER(ParticleSpecies, glm::vec4, _color, _color)
+
+STD430_CHECK_LAYOUT(ParticleSpecies, PARTICLE_SPECIES_STD430_MEMBERS);
@@ -0,0 +1,112 @@
+#include "ParticleSpeciesSsbo.h"
+
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates space for the SSBO and dumps the given collection of species into it.  Also 
+    remembers the largest radius because the spatial structures are sized by it.
+Parameters:
+    speciesCollection   Self-explanatory
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ParticleSpeciesSsbo::ParticleSpeciesSsbo(const std::vector<ParticleSpecies> &speciesCollection) :
+    SsboBase(),  // generate buffers
+    _numSpecies(0),
+    _maxRadiusOfInfluence(0.0f)
+{
+    // ignore _numVertices because this SSBO does not draw
+    _numSpecies = speciesCollection.size();
+    for (size_t speciesIndex = 0; speciesIndex < speciesCollection.size(); speciesIndex++)
+    {
+        float radius = speciesCollection[speciesIndex]._radiusOfInfluence;
+        if (radius > _maxRadiusOfInfluence)
+        {
+            _maxRadiusOfInfluence = radius;
+        }
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    GLuint bufferSizeBytes = sizeof(ParticleSpecies) * speciesCollection.size();
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, speciesCollection.data(), GL_STATIC_DRAW);
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Does nothing.  Exists to be declared virtual so that the base class' destructor is called
+    upon object death.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+ParticleSpeciesSsbo::~ParticleSpeciesSsbo()
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Binds the SSBO object (a CPU-side thing) to its corresponding buffer in the shader (GPU).
+
+    Note: It is ok to call this function for multiple compute shaders so that the same SSBO can
+    be used in each shader.  No member variables are altered in this function.
+Parameters:
+    computeProgramId    Self-explanatory
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ParticleSpeciesSsbo::ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader)
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+
+    // see the corresponding area in ParticleSsbo::Init(...) for explanation
+    GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, bufferNameInShader.c_str());
+    glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _ssboBindingPointIndex);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId);
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The species do not draw, but the particle render shader reads their colors out of the 
+    storage buffer (not a vertex attribute, because it is indexed by species and not by 
+    vertex), so this binds the buffer to that shader's "ParticleSpeciesBuffer" block the same 
+    way that ConfigureCompute(...) does.
+Parameters:
+    renderProgramId     Self-explanatory
+    drawStyle           Ignored.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ParticleSpeciesSsbo::ConfigureRender(unsigned int renderProgramId, unsigned int)
+{
+    ConfigureCompute(renderProgramId, "ParticleSpeciesBuffer");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of species in the table.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleSpeciesSsbo::NumSpecies() const
+{
+    return _numSpecies;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the largest radius of any species.  The spatial structures are sized 
+    so that the largest particles still only reach into their neighbors.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+float ParticleSpeciesSsbo::MaxRadiusOfInfluence() const
+{
+    return _maxRadiusOfInfluence;
+}
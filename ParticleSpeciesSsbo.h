@@ -0,0 +1,28 @@
+#pragma once
+
+#include "SsboBase.h"
+#include "ParticleSpecies.h"
+#include <vector>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the Shader Storage Block Object for the table of particle species.  The table is 
+    read by the compute shaders that need a particle's mass or radius and by the particle 
+    render shader for the species' color.  It is only written on the CPU side.
+-----------------------------------------------------------------------------------------------*/
+class ParticleSpeciesSsbo : public SsboBase
+{
+public:
+    ParticleSpeciesSsbo(const std::vector<ParticleSpecies> &speciesCollection);
+    virtual ~ParticleSpeciesSsbo();
+
+    void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
+    void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+
+    unsigned int NumSpecies() const;
+    float MaxRadiusOfInfluence() const;
+
+private:
+    unsigned int _numSpecies;
+    float _maxRadiusOfInfluence;
+};
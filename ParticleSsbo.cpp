@@ -1,10 +1,87 @@
 #include "ParticleSsbo.h"
 
 #include <vector>
+#include <stddef.h>     // for offsetof
 
 #include "glload/include/glload/gl_4_4.h"
 #include "ShaderStorage.h"
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The small values of a particle, which share one buffer in "structure of arrays" storage 
+    because the shaders that read one of them usually read the others too.  MUST match the 
+    version in particleStorage.glsl.
+
+    Note: std430 packs an array of these with no padding (they are all 4-byte scalars), so 
+    this is 20 bytes on both sides (checked below; see Std430Layout.h).
+-----------------------------------------------------------------------------------------------*/
+struct ParticleState
+{
+    int _collisionCountThisFrame;
+    unsigned int _speciesIndex;
+    int _isActive;
+    float _timeOfImpact;
+    unsigned int _framesAtRest;
+};
+
+#define PARTICLE_STATE_STD430_MEMBERS(MEMBER) \
+    MEMBER(ParticleState, int, _collisionCountThisFrame, _collisionCountThisFrame) \
+    MEMBER(ParticleState, unsigned int, _speciesIndex, _speciesIndex) \
+    MEMBER(ParticleState, int, _isActive, _isActive) \
+    MEMBER(ParticleState, float, _timeOfImpact, _timeOfImpact) \
+    MEMBER(ParticleState, unsigned int, _framesAtRest, _framesAtRest)
+
+STD430_CHECK_LAYOUT(ParticleState, PARTICLE_STATE_STD430_MEMBERS);
+
+// indices into the "structure of arrays" extra buffers
+// Note: MUST match the order of the names below.
+enum ExtraBuffer
+{
+    EXTRA_BUFFER_VELOCITY = 0,
+    EXTRA_BUFFER_NET_FORCE,
+    EXTRA_BUFFER_PREVIOUS_POSITION,
+    EXTRA_BUFFER_STATE,
+    EXTRA_BUFFER_NODE_INDEX
+};
+
+// in the shader, each buffer's name is the name given to ConfigureCompute(...) with the 
+// trailing "Buffer" replaced by one of these (ex: "ParticleBuffer" -> "ParticleVelocityBuffer")
+static const char *POSITION_BUFFER_NAME_SUFFIX = "PositionBuffer";
+static const char *EXTRA_BUFFER_NAME_SUFFIXES[] =
+{
+    "VelocityBuffer",
+    "ForceBuffer",
+    "PreviousPositionBuffer",
+    "StateBuffer",
+    "NodeIndexBuffer"
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Binds the given buffer to the compute shader's storage block of the given name, but only if 
+    the shader has that block.  In "structure of arrays" storage, a shader only declares (or 
+    at least only uses, which is what makes a block active) the parts of the particle that it 
+    needs.
+Parameters:
+    computeProgramId    Self-explanatory
+    blockNameInShader   Self-explanatory
+    bindingPointIndex   Self-explanatory
+    bufferId            Self-explanatory
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+static void BindStorageBlockIfActive(unsigned int computeProgramId, 
+    const std::string &blockNameInShader, unsigned int bindingPointIndex, unsigned int bufferId)
+{
+    GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, blockNameInShader.c_str());
+    if (storageBlockIndex == GL_INVALID_INDEX)
+    {
+        return;
+    }
+
+    glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, bindingPointIndex);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingPointIndex, bufferId);
+}
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     Ensures that the object starts object with initialized values and that the buffer's size is 
@@ -19,17 +96,83 @@ Description:
 
     So it makes sense to generate the buffer and set its size and contents in one place, and
     then to configure each shader separately.
-Parameters: None
+
+    In "structure of arrays" storage, the particles are split up into their parts here, and 
+    each part gets its own buffer and binding point.
+Parameters:
+    allParticles    Self-explanatory
+    storageLayout   See ParticleSsbo.h.
 Returns:    None
 Creator: John Cox, 9-6-2016
 -----------------------------------------------------------------------------------------------*/
-ParticleSsbo::ParticleSsbo(const std::vector<Particle> &allParticles) :
-    SsboBase()  // generate buffers
+ParticleSsbo::ParticleSsbo(const std::vector<Particle> &allParticles, 
+    StorageLayout storageLayout) :
+    SsboBase(),  // generate buffers
+    _storageLayout(storageLayout)
 {
+    for (unsigned int extraBufferIndex = 0; extraBufferIndex < NUM_EXTRA_BUFFERS; extraBufferIndex++)
+    {
+        _extraBufferIds[extraBufferIndex] = 0;
+        _extraBindingPointIndices[extraBufferIndex] = 0;
+    }
+
     _numVertices = allParticles.size();
+
+    if (_storageLayout == ARRAY_OF_STRUCTURES)
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+        GLuint bufferSizeBytes = sizeof(Particle) * allParticles.size();
+        glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, allParticles.data(), GL_STATIC_DRAW);
+
+        // cleanup
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        return;
+    }
+
+    std::vector<glm::vec4> positions(allParticles.size());
+    std::vector<glm::vec4> velocities(allParticles.size());
+    std::vector<glm::vec4> netForces(allParticles.size());
+    std::vector<glm::vec2> previousPositions(allParticles.size());
+    std::vector<ParticleState> states(allParticles.size());
+    std::vector<unsigned int> nodeIndices(allParticles.size());
+    for (size_t particleIndex = 0; particleIndex < allParticles.size(); particleIndex++)
+    {
+        const Particle &p = allParticles[particleIndex];
+        positions[particleIndex] = p._position;
+        velocities[particleIndex] = p._velocity;
+        netForces[particleIndex] = p._netForceThisFrame;
+        previousPositions[particleIndex] = p._previousPosition;
+        states[particleIndex]._collisionCountThisFrame = p._collisionCountThisFrame;
+        states[particleIndex]._speciesIndex = p._speciesIndex;
+        states[particleIndex]._isActive = p._isActive;
+        states[particleIndex]._timeOfImpact = p._timeOfImpact;
+        states[particleIndex]._framesAtRest = p._framesAtRest;
+        nodeIndices[particleIndex] = p._indexOfNodeThatItIsOccupying;
+    }
+
+    glGenBuffers(NUM_EXTRA_BUFFERS, _extraBufferIds);
+    for (unsigned int extraBufferIndex = 0; extraBufferIndex < NUM_EXTRA_BUFFERS; extraBufferIndex++)
+    {
+        _extraBindingPointIndices[extraBufferIndex] = NewStorageBlockBindingPointIndex();
+    }
+
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
-    GLuint bufferSizeBytes = sizeof(Particle) * allParticles.size();
-    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, allParticles.data(), GL_STATIC_DRAW);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(glm::vec4) * positions.size(), positions.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _extraBufferIds[EXTRA_BUFFER_VELOCITY]);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(glm::vec4) * velocities.size(), velocities.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _extraBufferIds[EXTRA_BUFFER_NET_FORCE]);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(glm::vec4) * netForces.size(), netForces.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _extraBufferIds[EXTRA_BUFFER_PREVIOUS_POSITION]);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(glm::vec2) * previousPositions.size(), previousPositions.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _extraBufferIds[EXTRA_BUFFER_STATE]);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(ParticleState) * states.size(), states.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _extraBufferIds[EXTRA_BUFFER_NODE_INDEX]);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(unsigned int) * nodeIndices.size(), nodeIndices.data(), GL_STATIC_DRAW);
 
     // cleanup
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
@@ -37,26 +180,46 @@ ParticleSsbo::ParticleSsbo(const std::vector<Particle> &allParticles) :
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Does nothing.  Exists to be declared virtual so that the base class' destructor is called
-    upon object death.
+    Deletes the "structure of arrays" buffers, if there are any (glDeleteBuffers(...) silently 
+    ignores 0s).  Also exists to be declared virtual so that the base class' destructor is 
+    called upon object death.
 Parameters: None
 Returns:    None
 Creator: John Cox, 9-6-2016
 -----------------------------------------------------------------------------------------------*/
 ParticleSsbo::~ParticleSsbo()
 {
+    glDeleteBuffers(NUM_EXTRA_BUFFERS, _extraBufferIds);
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
     Binds the SSBO object (a CPU-side thing) to its corresponding buffer in the shader (GPU).
+
+    In "structure of arrays" storage, each part's buffer is bound to its own storage block 
+    (see BindStorageBlockIfActive(...)).
 Parameters: 
     computeProgramId    Self-explanatory
+    bufferNameInShader  Self-explanatory
 Returns:    None
 Creator: John Cox, 11-24-2016
 -----------------------------------------------------------------------------------------------*/
 void ParticleSsbo::ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader)
 {
+    if (_storageLayout == STRUCTURE_OF_ARRAYS)
+    {
+        std::string blockNamePrefix = bufferNameInShader.substr(0, bufferNameInShader.rfind("Buffer"));
+        BindStorageBlockIfActive(computeProgramId, blockNamePrefix + POSITION_BUFFER_NAME_SUFFIX, 
+            _ssboBindingPointIndex, _bufferId);
+        for (unsigned int extraBufferIndex = 0; extraBufferIndex < NUM_EXTRA_BUFFERS; extraBufferIndex++)
+        {
+            BindStorageBlockIfActive(computeProgramId, 
+                blockNamePrefix + EXTRA_BUFFER_NAME_SUFFIXES[extraBufferIndex], 
+                _extraBindingPointIndices[extraBufferIndex], _extraBufferIds[extraBufferIndex]);
+        }
+        return;
+    }
+
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
 
     // binding requires some setup
@@ -114,6 +277,17 @@ void ParticleSsbo::ConfigureRender(unsigned int renderProgramId, unsigned int dr
     glUseProgram(renderProgramId);
     glBindVertexArray(_vaoId);
 
+    if (_storageLayout == STRUCTURE_OF_ARRAYS)
+    {
+        ConfigureRenderStructureOfArrays();
+
+        // cleanup
+        glBindVertexArray(0);   // unbind this BEFORE the array
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glUseProgram(0);    // render program
+        return;
+    }
+
     // the vertex array attributes only work on whatever is bound to the array buffer, so bind 
     // shader storage buffer to the array buffer, set up the vertex array attributes, and the 
     // VAO will then use the buffer ID of whatever is bound to it
@@ -124,9 +298,9 @@ void ParticleSsbo::ConfigureRender(unsigned int renderProgramId, unsigned int dr
     // - glm::vec4 _position;
     // - glm::vec4 _velocity;
     // - glm::vec4 _netForceThisFrame;
+    // - glm::vec2 _previousPosition (not rendered, so no attribute)
     // - int _collisionCountThisFrame;
-    // - float _mass;
-    // - float _radiusOfInfluence;
+    // - unsigned int _speciesIndex;
     // - unsigned int _indexOfNodeThatItIsOccupying;
     // - int _isActive;
 
@@ -163,6 +337,12 @@ void ParticleSsbo::ConfigureRender(unsigned int renderProgramId, unsigned int dr
         (void *)bufferStartOffset);
     sizeOfLastItem = sizeof(Particle::_netForceThisFrame);
 
+    // previous position
+    // Note: Only used by the compute shaders, so skip over it instead of giving it an 
+    // attribute.  That keeps the attribute locations in the render shader the same.
+    bufferStartOffset += sizeOfLastItem;
+    sizeOfLastItem = sizeof(Particle::_previousPosition);
+
     // collision count this frame
     itemType = GL_INT;
     numItems = sizeof(Particle::_collisionCountThisFrame) / sizeof(int);
@@ -173,25 +353,15 @@ void ParticleSsbo::ConfigureRender(unsigned int renderProgramId, unsigned int dr
         (void *)bufferStartOffset);
     sizeOfLastItem = sizeof(Particle::_collisionCountThisFrame);
 
-    // mass
-    itemType = GL_FLOAT;
-    numItems = sizeof(Particle::_mass) / sizeof(float);
-    bufferStartOffset += sizeOfLastItem;
-    vertexArrayIndex++;
-    glEnableVertexAttribArray(vertexArrayIndex);
-    glVertexAttribPointer(vertexArrayIndex, numItems, itemType, GL_FALSE, bytesPerStep,
-        (void *)bufferStartOffset);
-    sizeOfLastItem = sizeof(Particle::_mass);
-
-    // radius of influence
-    itemType = GL_FLOAT;
-    numItems = sizeof(Particle::_radiusOfInfluence) / sizeof(float);
+    // species index
+    itemType = GL_UNSIGNED_INT;
+    numItems = sizeof(Particle::_speciesIndex) / sizeof(unsigned int);
     bufferStartOffset += sizeOfLastItem;
     vertexArrayIndex++;
     glEnableVertexAttribArray(vertexArrayIndex);
-    glVertexAttribPointer(vertexArrayIndex, numItems, itemType, GL_FALSE, bytesPerStep,
+    glVertexAttribIPointer(vertexArrayIndex, numItems, itemType, bytesPerStep,
         (void *)bufferStartOffset);
-    sizeOfLastItem = sizeof(Particle::_radiusOfInfluence);
+    sizeOfLastItem = sizeof(Particle::_speciesIndex);
 
     // index of node that it is occupying
     itemType = GL_UNSIGNED_INT;
@@ -218,3 +388,62 @@ void ParticleSsbo::ConfigureRender(unsigned int renderProgramId, unsigned int dr
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glUseProgram(0);    // render program
 }
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The "structure of arrays" version of the vertex attribute pointers.  Each attribute comes 
+    out of the buffer that its part of the particle lives in, so the buffer that is bound to 
+    the array buffer changes along the way (the VAO remembers which buffer each attribute was 
+    set up with).  The attribute locations are the same as in the "array of structures" 
+    version, so the render shader doesn't care which one is in use.
+
+    Note: The render program and the VAO MUST already be bound (see ConfigureRender(...)).
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ParticleSsbo::ConfigureRenderStructureOfArrays()
+{
+    // position, velocity, and net force each have a tightly packed buffer
+    // Note: The previous position is not rendered, so it has no attribute.
+    unsigned int vec4BufferIds[] =
+    {
+        _bufferId,
+        _extraBufferIds[EXTRA_BUFFER_VELOCITY],
+        _extraBufferIds[EXTRA_BUFFER_NET_FORCE]
+    };
+    unsigned int vertexArrayIndex = 0;
+    for (; vertexArrayIndex < 3; vertexArrayIndex++)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, vec4BufferIds[vertexArrayIndex]);
+        glEnableVertexAttribArray(vertexArrayIndex);
+        glVertexAttribPointer(vertexArrayIndex, sizeof(glm::vec4) / sizeof(float), GL_FLOAT, 
+            GL_FALSE, sizeof(glm::vec4), (void *)0);
+    }
+
+    // collision count this frame
+    unsigned int bytesPerStep = sizeof(ParticleState);
+    glBindBuffer(GL_ARRAY_BUFFER, _extraBufferIds[EXTRA_BUFFER_STATE]);
+    glEnableVertexAttribArray(vertexArrayIndex);
+    glVertexAttribIPointer(vertexArrayIndex, 1, GL_INT, bytesPerStep,
+        (void *)offsetof(ParticleState, _collisionCountThisFrame));
+
+    // species index
+    vertexArrayIndex++;
+    glEnableVertexAttribArray(vertexArrayIndex);
+    glVertexAttribIPointer(vertexArrayIndex, 1, GL_UNSIGNED_INT, bytesPerStep,
+        (void *)offsetof(ParticleState, _speciesIndex));
+
+    // index of node that it is occupying
+    vertexArrayIndex++;
+    glBindBuffer(GL_ARRAY_BUFFER, _extraBufferIds[EXTRA_BUFFER_NODE_INDEX]);
+    glEnableVertexAttribArray(vertexArrayIndex);
+    glVertexAttribIPointer(vertexArrayIndex, 1, GL_UNSIGNED_INT, sizeof(unsigned int), 
+        (void *)0);
+
+    // "is active" flag
+    vertexArrayIndex++;
+    glBindBuffer(GL_ARRAY_BUFFER, _extraBufferIds[EXTRA_BUFFER_STATE]);
+    glEnableVertexAttribArray(vertexArrayIndex);
+    glVertexAttribIPointer(vertexArrayIndex, 1, GL_INT, bytesPerStep,
+        (void *)offsetof(ParticleState, _isActive));
+}
@@ -10,15 +10,40 @@ Description:
     is big enough to store the requested number of particles, and since this buffer will be used 
     in a drawing shader as well as a compute shader, this class will also up the VAO and the 
     vertex attributes.
+
+    The particles can be stored as one buffer of whole Particle structures ("array of 
+    structures") or split up into one buffer per part of the particle ("structure of arrays"; 
+    see particleStorage.glsl), so that a shader that only needs, say, the positions doesn't 
+    drag the rest of each particle through the cache along with them.  The shaders MUST be 
+    compiled for the same layout (see ShaderStorage::SetPreprocessorDefines(...)).
 Creator:    John Cox (9-3-2016)
 -----------------------------------------------------------------------------------------------*/
 class ParticleSsbo : public SsboBase
 {
 public:
-    ParticleSsbo(const std::vector<Particle> &allParticles);
+    enum StorageLayout
+    {
+        ARRAY_OF_STRUCTURES = 0,
+        STRUCTURE_OF_ARRAYS
+    };
+
+    ParticleSsbo(const std::vector<Particle> &allParticles, 
+        StorageLayout storageLayout = ARRAY_OF_STRUCTURES);
     virtual ~ParticleSsbo();
     
     void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
     void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+
+private:
+    void ConfigureRenderStructureOfArrays();
+
+    StorageLayout _storageLayout;
+
+    // "structure of arrays" only; the base class' buffer holds the positions and these hold 
+    // the velocities, net forces, previous positions, small values, and node indices, in that 
+    // order (see particleStorage.glsl)
+    static const unsigned int NUM_EXTRA_BUFFERS = 5;
+    unsigned int _extraBufferIds[NUM_EXTRA_BUFFERS];
+    unsigned int _extraBindingPointIndices[NUM_EXTRA_BUFFERS];
 };
 
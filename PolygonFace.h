@@ -44,3 +44,10 @@ struct PolygonFace
     MyVertex _start;
     MyVertex _end;
 };
+
+// the members that the GPU sees, in order, with their names in GLSL (see Std430Layout.h)
+#define POLYGON_FACE_STD430_MEMBERS(MEMBER) \
+    MEMBER(PolygonFace, MyVertex, _start, _start) \
+    MEMBER(PolygonFace, MyVertex, _end, _end)
+
+STD430_CHECK_LAYOUT(PolygonFace, POLYGON_FACE_STD430_MEMBERS);
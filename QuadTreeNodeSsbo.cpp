@@ -6,24 +6,49 @@
 Description:
     Calls the base class to give members initial values (zeros).
 
-    Allocates space for the SSBO and dumps the given collection of node data into it.
+    Allocates space for the SSBO and dumps the given collection of node edges into it.
 Parameters:
-faceCollection  Self-explanatory
+    boundsCollection    Self-explanatory
 Returns:    None
-Creator: John Cox, 1-16-2017
 -----------------------------------------------------------------------------------------------*/
-QuadTreeNodeSsbo::QuadTreeNodeSsbo(const std::vector<ParticleQuadTreeNode> &nodeCollection) :
-    SsboBase()  // generate buffers
+QuadTreeNodeSsbo::QuadTreeNodeSsbo(const std::vector<ParticleQuadTreeNodeBounds> &boundsCollection) :
+    SsboBase(),  // generate buffers
+    _bufferSizeBytes(0)
 {
-    // ignore _numVertices because this SSBO does not draw
+    Init(boundsCollection.data(), sizeof(ParticleQuadTreeNodeBounds) * boundsCollection.size());
+}
 
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
-    GLuint bufferSizeBytes = sizeof(ParticleQuadTreeNode) * nodeCollection.size();
-    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, nodeCollection.data(), GL_STATIC_DRAW);
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
 
-    // cleanup
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    Allocates space for the SSBO and dumps the given collection of node neighbors into it.
+Parameters:
+    neighborsCollection Self-explanatory
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+QuadTreeNodeSsbo::QuadTreeNodeSsbo(const std::vector<ParticleQuadTreeNodeNeighbors> &neighborsCollection) :
+    SsboBase(),  // generate buffers
+    _bufferSizeBytes(0)
+{
+    Init(neighborsCollection.data(), sizeof(ParticleQuadTreeNodeNeighbors) * neighborsCollection.size());
+}
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates space for the SSBO and dumps the given collection of node counts (and the flags 
+    and child indices that go with them) into it.
+Parameters:
+    countsCollection    Self-explanatory
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+QuadTreeNodeSsbo::QuadTreeNodeSsbo(const std::vector<ParticleQuadTreeNodeCounts> &countsCollection) :
+    SsboBase(),  // generate buffers
+    _bufferSizeBytes(0)
+{
+    Init(countsCollection.data(), sizeof(ParticleQuadTreeNodeCounts) * countsCollection.size());
 }
 
 /*-----------------------------------------------------------------------------------------------
@@ -82,3 +107,38 @@ Creator: John Cox, 1-16-2017
 void QuadTreeNodeSsbo::ConfigureRender(unsigned int, unsigned int)
 {
 }
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the size of this part of the nodes.  Useful for comparing how much 
+    memory each shader has to look through.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int QuadTreeNodeSsbo::BufferSizeBytes() const
+{
+    return _bufferSizeBytes;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The constructors only differ in the type of node data that they are given, so they all 
+    hand it off to this to do the upload.
+Parameters:
+    data            The start of the node data.
+    bufferSizeBytes Self-explanatory
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeNodeSsbo::Init(const void *data, unsigned int bufferSizeBytes)
+{
+    // ignore _numVertices because this SSBO does not draw
+    _bufferSizeBytes = bufferSizeBytes;
+
+    // the counts are rewritten every frame, so don't use GL_STATIC_DRAW
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, _bufferSizeBytes, data, GL_DYNAMIC_COPY);
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
@@ -6,20 +6,28 @@
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Sets up the Shader Storage Block Object for quad tree nodes.  The polygon will be used in 
-    the compute shader only.
+    Sets up the Shader Storage Block Object for one part of the quad tree nodes (see 
+    ParticleQuadTreeNode.h for why the nodes are split up).  There is one constructor per part, 
+    and each part gets its own SSBO.  The nodes' particle indices are just unsigned integers, 
+    so they go into a UintSsbo instead.  These will be used in the compute shader only.
 Creator: John Cox, 1/16/2017
 -----------------------------------------------------------------------------------------------*/
 class QuadTreeNodeSsbo : public SsboBase
 {
 public:
-    QuadTreeNodeSsbo(const std::vector<ParticleQuadTreeNode> &nodeCollection);
+    QuadTreeNodeSsbo(const std::vector<ParticleQuadTreeNodeBounds> &boundsCollection);
+    QuadTreeNodeSsbo(const std::vector<ParticleQuadTreeNodeNeighbors> &neighborsCollection);
+    QuadTreeNodeSsbo(const std::vector<ParticleQuadTreeNodeCounts> &countsCollection);
     virtual ~QuadTreeNodeSsbo();
 
     void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
     void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
 
+    unsigned int BufferSizeBytes() const;
+
 private:
+    void Init(const void *data, unsigned int bufferSizeBytes);
+
     unsigned int _bufferSizeBytes;
 };
 
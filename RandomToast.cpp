@@ -101,3 +101,104 @@ glm::vec3 RandomColor()
     ret.z = RandomOnRange0to1();
     return ret;
 }
+
+// Philox4x32's multipliers and key increments (see Random123, Salmon et al., "Parallel Random 
+// Numbers: As Easy as 1, 2, 3", 2011)
+// Note: MUST match the values in counterRandom.glsl.
+static const unsigned int PHILOX_M4X32_0 = 0xD2511F53;
+static const unsigned int PHILOX_M4X32_1 = 0xCD9E8D57;
+static const unsigned int PHILOX_W32_0 = 0x9E3779B9;
+static const unsigned int PHILOX_W32_1 = 0xBB67AE85;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Philox4x32 with 10 rounds.  Scrambles a 128bit counter with a 64bit key into 128 bits that 
+    pass the BigCrush tests.  Each round multiplies two of the words into 64bit products and 
+    swaps the halves around, mixing in the other two words and the key.
+Parameters:
+    counter     Where the numbers are in the stream.
+    key         Which stream.
+Returns:
+    4 random unsigned ints.
+-----------------------------------------------------------------------------------------------*/
+glm::uvec4 Philox4x32(glm::uvec4 counter, glm::uvec2 key)
+{
+    for (int round = 0; round < 10; round++)
+    {
+        if (round > 0)
+        {
+            key.x += PHILOX_W32_0;
+            key.y += PHILOX_W32_1;
+        }
+
+        unsigned long long product0 = static_cast<unsigned long long>(PHILOX_M4X32_0) * counter.x;
+        unsigned long long product1 = static_cast<unsigned long long>(PHILOX_M4X32_1) * counter.z;
+        unsigned int hi0 = static_cast<unsigned int>(product0 >> 32);
+        unsigned int lo0 = static_cast<unsigned int>(product0);
+        unsigned int hi1 = static_cast<unsigned int>(product1 >> 32);
+        unsigned int lo1 = static_cast<unsigned int>(product1);
+        counter = glm::uvec4(hi1 ^ counter.y ^ key.x, lo1, hi0 ^ counter.w ^ key.y, lo0);
+    }
+
+    return counter;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts the stream of numbers for one particle in one frame.  The same as SeedRandom(...) 
+    in counterRandom.glsl.
+Parameters:
+    seed            The same for the whole run (see ComputeParticleReset::RandomSeed()).
+    particleIndex   Self-explanatory.
+    frameNumber     Self-explanatory.
+    streamId        One of RANDOM_STREAM.
+Returns:
+    A stream that hasn't handed out any numbers yet.
+-----------------------------------------------------------------------------------------------*/
+RandomStream NewRandomStream(unsigned int seed, unsigned int particleIndex, unsigned int frameNumber, unsigned int streamId)
+{
+    RandomStream stream;
+    stream._counter = glm::uvec4(particleIndex, frameNumber, streamId, 0);
+    stream._key = glm::uvec2(seed, 0);
+    stream._block = glm::uvec4(0);
+    stream._numUsedInBlock = 4;
+    return stream;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Hands out the stream's next number.  Every 4th call hashes the next block.
+Parameters:
+    stream  Self-explanatory.
+Returns:
+    A random unsigned int.
+-----------------------------------------------------------------------------------------------*/
+unsigned int RandomUint(RandomStream &stream)
+{
+    if (stream._numUsedInBlock == 4)
+    {
+        stream._block = Philox4x32(stream._counter, stream._key);
+        stream._counter.w++;
+        stream._numUsedInBlock = 0;
+    }
+
+    unsigned int value = stream._block[stream._numUsedInBlock];
+    stream._numUsedInBlock++;
+    return value;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Generates a random positive float on the range [0,+1) from the stream's next number.
+
+    Note: Only the top 24 bits are used because that is all that a float can hold exactly, 
+    and scaling by a power of 2 is exact, so the GPU gets the same float.
+Parameters:
+    stream  Self-explanatory.
+Returns:    
+    See description.
+-----------------------------------------------------------------------------------------------*/
+float RandomOnRange0to1(RandomStream &stream)
+{
+    return static_cast<float>(RandomUint(stream) >> 8) * (1.0f / 16777216.0f);
+}
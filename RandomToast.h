@@ -1,6 +1,8 @@
 #pragma once
 
+#include "glm/vec2.hpp"
 #include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
 
 /*-----------------------------------------------------------------------------------------------
 Description:
@@ -23,3 +25,40 @@ float RandomOnRange0to1();
 unsigned long Random();
 long RandomPosAndNeg();
 glm::vec3 RandomColor();
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The counter-based random numbers that the "particle reset" shader uses (see 
+    counterRandom.glsl), done the same way on the CPU side so that the two can be checked 
+    against each other.  Given the same seed, particle index, frame number, and stream, both 
+    sides give the exact same numbers, bit for bit.
+
+    Unlike xorshf96(), there is no hidden state.  Each number is a hash (Philox4x32-10) of 
+    where it is in the stream, so any one of them can be found without finding the ones before 
+    it, and nothing has to be shared between threads (or shader invocations).
+-----------------------------------------------------------------------------------------------*/
+
+// what the numbers are for, so that two uses with the same particle and frame don't get the 
+// same numbers
+// Note: MUST match the values in counterRandom.glsl.
+enum RANDOM_STREAM
+{
+    RANDOM_STREAM_PARTICLE_RESET = 0,
+    RANDOM_STREAM_POLYGON_REGION = 1
+};
+
+struct RandomStream
+{
+    // particle index, frame number, stream, and which block of 4 numbers is next
+    glm::uvec4 _counter;
+    glm::uvec2 _key;
+
+    // 4 numbers come out of each hash
+    glm::uvec4 _block;
+    unsigned int _numUsedInBlock;
+};
+
+glm::uvec4 Philox4x32(glm::uvec4 counter, glm::uvec2 key);
+RandomStream NewRandomStream(unsigned int seed, unsigned int particleIndex, unsigned int frameNumber, unsigned int streamId);
+unsigned int RandomUint(RandomStream &stream);
+float RandomOnRange0to1(RandomStream &stream);
@@ -122,11 +122,101 @@ void ShaderStorage::DeleteProgram(const std::string &programKey)
     }
 }
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets the "#define" lines that every shader file added after this will be compiled with, 
+    such as the particle storage layout (see particleStorage.glsl).  They go right after the 
+    "#version" line, which GLSL requires to come first.
+Parameters:
+    defines     Whole lines, each one ending in a newline.  Empty for none.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ShaderStorage::SetPreprocessorDefines(const std::string &defines)
+{
+    _preprocessorDefines = defines;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives the shaders a #include that isn't a file.  Used for the GLSL versions of the 
+    structures that are shared with the CPU, which are generated from the C++ versions (see 
+    Std430Layout.h) so that the two can't drift apart.
+
+    MUST be called before any shader that includes it is added.
+Parameters:
+    includeName     What goes in the quotes of the #include line.
+    contents        What the #include line is replaced with.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void ShaderStorage::AddGeneratedInclude(const std::string &includeName, const std::string &contents)
+{
+    _generatedIncludes[includeName] = contents;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Reads the whole file into a string.  GLSL has no "#include" of its own, so any line that 
+    starts with #include "name" is replaced with the contents of the generated include by that 
+    name (see AddGeneratedInclude(...)) or, if there isn't one, the file by that name.  That 
+    lets declarations that many shaders share live in one place.  Included files can include 
+    other files, but there are no include guards, so nothing may be included twice.
+Parameters:
+    filePath        Can be relative to program or an absolute path.  Included files are 
+                    relative to the program.
+    includeDepth    0 for the shader file itself.  Stops includes that include each other.
+Returns:
+    The file's contents, or an empty string if it couldn't be read.
+-----------------------------------------------------------------------------------------------*/
+std::string ShaderStorage::ReadShaderFile(const std::string &filePath, unsigned int includeDepth) const
+{
+    std::ifstream shaderFile(filePath);
+    std::string fileContents;
+    std::string line;
+    const std::string includeDirective = "#include \"";
+    const unsigned int MAX_INCLUDE_DEPTH = 8;
+    while (std::getline(shaderFile, line))
+    {
+        if (line.compare(0, includeDirective.length(), includeDirective) != 0)
+        {
+            fileContents += line;
+            fileContents += "\n";
+            continue;
+        }
+
+        size_t nameEnd = line.find('"', includeDirective.length());
+        std::string includePath = line.substr(includeDirective.length(), nameEnd - includeDirective.length());
+        std::string includeContents;
+        _GENERATED_INCLUDE_MAP::const_iterator generatedItr = _generatedIncludes.find(includePath);
+        if (generatedItr != _generatedIncludes.end())
+        {
+            includeContents = generatedItr->second;
+        }
+        else if (includeDepth < MAX_INCLUDE_DEPTH)
+        {
+            includeContents = ReadShaderFile(includePath, includeDepth + 1);
+        }
+
+        if (includeContents.length() == 0)
+        {
+            fprintf(stderr, "Shader file '%s' included '%s', which is empty, missing, or included too deep\n", 
+                filePath.c_str(), includePath.c_str());
+        }
+        fileContents += includeContents;
+        fileContents += "\n";
+    }
+    shaderFile.close();
+
+    return fileContents;
+}
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     Reads the specified file and attempts to compile it into the specified shader type.  Stores
     the binary in a collection of binaries under the specified key.
 
+    Any preprocessor defines (see SetPreprocessorDefines(...)) are added after the "#version" 
+    line, and any #include lines are expanded (see ReadShaderFile(...)).
+
     Prints its own errors to stderr.  The APIENTRY debug function doesn't report shader compile
     errors.
 Parameters:
@@ -146,11 +236,7 @@ void ShaderStorage::AddShaderFile(const std::string &programKey, const std::stri
         return;
     }
 
-    std::ifstream shaderFile(filePath);
-    std::stringstream shaderData;
-    shaderData << shaderFile.rdbuf();
-    shaderFile.close();
-    std::string fileContents = shaderData.str();
+    std::string fileContents = ReadShaderFile(filePath, 0);
 
     if (fileContents.length() == 0)
     {
@@ -158,15 +244,20 @@ void ShaderStorage::AddShaderFile(const std::string &programKey, const std::stri
         return;
     }
 
+    // the "#version" line has to come first, so the defines go in after it
+    size_t versionLineEnd = fileContents.find('\n') + 1;
+    std::string versionLine = fileContents.substr(0, versionLineEnd);
+    std::string restOfFile = fileContents.substr(versionLineEnd);
+
     // OpenGL takes pointers to file contents and pointers to file content lengths, so use arrays
-    const GLchar *bytes[] = { fileContents.c_str() };
-    const GLint strLengths[] = { (int)fileContents.length() };
+    const GLchar *bytes[] = { versionLine.c_str(), _preprocessorDefines.c_str(), restOfFile.c_str() };
+    const GLint strLengths[] = { (int)versionLine.length(), (int)_preprocessorDefines.length(), (int)restOfFile.length() };
 
     GLuint shaderId = glCreateShader(shaderType);
 
     // add the file contents to the shader
     // Note: An additional step is required for shader compilation.
-    glShaderSource(shaderId, 1, bytes, strLengths);
+    glShaderSource(shaderId, 3, bytes, strLengths);
     glCompileShader(shaderId);
 
     // ??necessary or will the APIENTRY debug function handle this??
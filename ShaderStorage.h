@@ -25,6 +25,8 @@ public:
     void NewShader(const std::string &programKey);
     void DeleteProgram(const std::string &programKey);
 
+    void SetPreprocessorDefines(const std::string &defines);
+    void AddGeneratedInclude(const std::string &includeName, const std::string &contents);
     void AddShaderFile(const std::string &programKey, const std::string &filePath,
         const GLenum shaderType);
     GLuint LinkShader(const std::string &programKey);
@@ -49,7 +51,14 @@ private:
     typedef std::map<std::string, std::vector<GLuint>> _BINARY_MAP;
     _BINARY_MAP _shaderBinaries;
 
+    // added to every shader after the "#version" line (see SetPreprocessorDefines(...))
+    std::string _preprocessorDefines;
 
+    // #include "name" -> contents (see AddGeneratedInclude(...))
+    typedef std::map<std::string, std::string> _GENERATED_INCLUDE_MAP;
+    _GENERATED_INCLUDE_MAP _generatedIncludes;
+
+    std::string ReadShaderFile(const std::string &filePath, unsigned int includeDepth) const;
 
     std::string _computeShaderContents;
 
@@ -2,8 +2,16 @@
 
 #include "glload/include/glload/gl_4_4.h"
 
-// TODO: header
-static unsigned int GetNewStorageBlockBindingPointIndex()
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Hands out a binding point that no other SSBO is using.  Every SSBO gets one in the 
+    constructor, and derived classes that have more than one buffer (see ParticleSsbo's 
+    "structure of arrays" storage) can ask for more.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int SsboBase::NewStorageBlockBindingPointIndex()
 {
     static GLuint ssboBindingPointIndex = 0;
 
@@ -32,7 +40,7 @@ SsboBase::SsboBase() :
     _bufferId(0),
     _drawStyle(0),
     _numVertices(0),
-    _ssboBindingPointIndex(GetNewStorageBlockBindingPointIndex())
+    _ssboBindingPointIndex(NewStorageBlockBindingPointIndex())
 {
     glGenBuffers(1, &_bufferId);
     glGenVertexArrays(1, &_vaoId);
@@ -41,4 +41,7 @@ protected:
 
     // set in constructor, read-only by derived classes
     const unsigned int _ssboBindingPointIndex;
+
+    // for derived classes that have more than one buffer, each of which needs its own binding
+    static unsigned int NewStorageBlockBindingPointIndex();
 };
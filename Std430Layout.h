@@ -0,0 +1,196 @@
+#pragma once
+
+#include <stddef.h>     // for offsetof
+#include <string>
+#include "glm/vec2.hpp"
+#include "glm/vec4.hpp"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The structures that are shared between the CPU and the compute shaders used to be written
+    out twice, once in C++ and once in every shader that used them, and kept in sync by hand.
+    A mismatch doesn't cause an error on either side.  The shader just reads the wrong bytes.
+    That is why the particle still uses vec4s for 2D positions: vec2s were tried once and the
+    particles went nowhere.
+
+    Now each shared structure lists its members once, in its header, as a macro:
+
+        #define PARTICLE_SPECIES_STD430_MEMBERS(MEMBER) \
+            MEMBER(ParticleSpecies, float, _mass, _mass) \
+            ...
+
+    (structure, C++ type, C++ name, GLSL name).  That list is used for two things:
+    (1) STD430_CHECK_LAYOUT(...) works out where std430 would put each member and fails to
+    compile if the C++ structure doesn't have it there, or if the C++ structure's size isn't
+    std430's array stride for it.  Padding members (like "int _padding[2]") are left out of the
+    list; they are only there to make the C++ side line up.
+    (2) STD430_GLSL_STRUCT(...) writes out the GLSL version of the structure, which is given to
+    the shaders as a generated #include (see ShaderStorage::AddGeneratedInclude(...)).
+
+    Only the types that have a Std430Type<...> are allowed in a shared structure.  Anything else
+    fails to compile, which is on purpose.  vec3 is left out because std430 aligns it like a
+    vec4 but only gives it 12 bytes, and that is exactly the kind of thing this is meant to
+    stop.  vec2 is in, since it is now safe to try.  Two halves can be packed into an unsigned
+    int (see packHalf2x16(...) in GLSL and glm::packHalf2x16(...) in C++).
+
+    Note: This is all C++11 (no C++14 constexpr loops) so that Visual Studio 2015 takes it.
+-----------------------------------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The std430 alignment and size of a type, and its name in GLSL.  Specialized for each type
+    that is allowed in a shared structure.  Shared structures can contain each other (see
+    STD430_STRUCT_TYPE(...)).
+-----------------------------------------------------------------------------------------------*/
+template<typename T>
+struct Std430Type;
+
+template<>
+struct Std430Type<float>
+{
+    static const size_t ALIGNMENT = 4;
+    static const size_t SIZE = 4;
+    static const char *GlslName() { return "float"; }
+};
+
+template<>
+struct Std430Type<int>
+{
+    static const size_t ALIGNMENT = 4;
+    static const size_t SIZE = 4;
+    static const char *GlslName() { return "int"; }
+};
+
+template<>
+struct Std430Type<unsigned int>
+{
+    static const size_t ALIGNMENT = 4;
+    static const size_t SIZE = 4;
+    static const char *GlslName() { return "uint"; }
+};
+
+template<>
+struct Std430Type<glm::vec2>
+{
+    static const size_t ALIGNMENT = 8;
+    static const size_t SIZE = 8;
+    static const char *GlslName() { return "vec2"; }
+};
+
+template<>
+struct Std430Type<glm::vec4>
+{
+    static const size_t ALIGNMENT = 16;
+    static const size_t SIZE = 16;
+    static const char *GlslName() { return "vec4"; }
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Rounds the offset up to the next multiple of the alignment.
+Parameters:
+    offset      Self-explanatory.
+    alignment   Self-explanatory.
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+constexpr size_t Std430AlignUp(size_t offset, size_t alignment)
+{
+    return ((offset + alignment - 1) / alignment) * alignment;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.  std::max(...) isn't constexpr until C++14.
+Parameters:
+    a, b    Self-explanatory.
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+constexpr size_t Std430Max(size_t a, size_t b)
+{
+    return (a > b) ? a : b;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One member of a shared structure: its type and where the C++ compiler put it.
+-----------------------------------------------------------------------------------------------*/
+template<typename T, size_t CPP_OFFSET>
+struct Std430Member
+{
+    typedef T Type;
+    static const size_t OFFSET = CPP_OFFSET;
+};
+
+// ends the list of members (the member list macros leave a trailing comma)
+struct Std430EndOfMembers
+{
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Walks the members of a shared structure in order, working out where std430 puts each one
+    (the end of the last one, rounded up to this one's alignment), and checks that against
+    where the C++ compiler put it.  Also works out where the last member ends and the largest
+    alignment of any member, which together give std430's array stride for the structure.
+-----------------------------------------------------------------------------------------------*/
+template<size_t NEXT_OFFSET, typename... MEMBERS>
+struct Std430Members;
+
+template<size_t NEXT_OFFSET>
+struct Std430Members<NEXT_OFFSET, Std430EndOfMembers>
+{
+    static const bool OFFSETS_MATCH = true;
+    static const size_t END = NEXT_OFFSET;
+    static const size_t ALIGNMENT = 1;
+};
+
+template<size_t NEXT_OFFSET, typename MEMBER, typename... REST>
+struct Std430Members<NEXT_OFFSET, MEMBER, REST...>
+{
+    typedef Std430Type<typename MEMBER::Type> MemberType;
+    static const size_t OFFSET = Std430AlignUp(NEXT_OFFSET, MemberType::ALIGNMENT);
+    typedef Std430Members<OFFSET + MemberType::SIZE, REST...> Rest;
+
+    static const bool OFFSETS_MATCH = (MEMBER::OFFSET == OFFSET) && Rest::OFFSETS_MATCH;
+    static const size_t END = Rest::END;
+    static const size_t ALIGNMENT = Std430Max(MemberType::ALIGNMENT, Rest::ALIGNMENT);
+};
+
+// turns one line of a member list into a Std430Member<...>
+#define STD430_MEMBER(structType, memberType, cppName, glslName) \
+    Std430Member<memberType, offsetof(structType, cppName)>,
+
+// the Std430Members<...> for a whole member list
+#define STD430_MEMBERS(MEMBER_LIST) \
+    Std430Members<0, MEMBER_LIST(STD430_MEMBER) Std430EndOfMembers>
+
+// goes after the structure's definition
+#define STD430_CHECK_LAYOUT(structType, MEMBER_LIST) \
+    static_assert(STD430_MEMBERS(MEMBER_LIST)::OFFSETS_MATCH, \
+        #structType " members are not where std430 puts them"); \
+    static_assert(sizeof(structType) == Std430AlignUp(STD430_MEMBERS(MEMBER_LIST)::END, \
+        STD430_MEMBERS(MEMBER_LIST)::ALIGNMENT), \
+        #structType " size is not its std430 array stride (missing or extra padding?)")
+
+// lets another shared structure contain this one
+// Note: Goes after STD430_CHECK_LAYOUT(...).  std430 aligns a structure to its largest member
+// (no rounding up to a vec4 like std140 does).
+#define STD430_STRUCT_TYPE(structType, MEMBER_LIST) \
+    template<> \
+    struct Std430Type<structType> \
+    { \
+        static const size_t ALIGNMENT = STD430_MEMBERS(MEMBER_LIST)::ALIGNMENT; \
+        static const size_t SIZE = Std430AlignUp(STD430_MEMBERS(MEMBER_LIST)::END, ALIGNMENT); \
+        static const char *GlslName() { return #structType; } \
+    }
+
+// turns one line of a member list into a line of GLSL
+#define STD430_GLSL_MEMBER(structType, memberType, cppName, glslName) \
+    + "    " + std::string(Std430Type<memberType>::GlslName()) + " " #glslName ";\n"
+
+// the GLSL definition of a shared structure, as a std::string
+// Note: GLSL has no padding members.  std430 does the same thing that they do on the C++ side.
+#define STD430_GLSL_STRUCT(structType, MEMBER_LIST) \
+    (std::string("struct " #structType "\n{\n") MEMBER_LIST(STD430_GLSL_MEMBER) + "};\n")
@@ -0,0 +1,96 @@
+#include "UintSsbo.h"
+
+#include <vector>
+
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates space for the SSBO and fills it with zeros.
+Parameters:
+    numItems    How many unsigned integers the buffer holds.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+UintSsbo::UintSsbo(unsigned int numItems) :
+    SsboBase(),  // generate buffers
+    _numItems(numItems)
+{
+    // ignore _numVertices because this SSBO does not draw
+
+    std::vector<unsigned int> allZeros(numItems, 0);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    GLuint bufferSizeBytes = sizeof(unsigned int) * numItems;
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, allZeros.data(), GL_DYNAMIC_COPY);
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Does nothing.  Exists to be declared virtual so that the base class' destructor is called
+    upon object death.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+UintSsbo::~UintSsbo()
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Binds the SSBO object (a CPU-side thing) to its corresponding buffer in the shader (GPU).
+
+    Note: It is ok to call this function for multiple compute shaders so that the same SSBO can
+    be used in each shader.  No member variables are altered in this function.
+
+    Also Note: If the shader doesn't have the buffer (its mode was compiled out), then nothing 
+    is bound.
+Parameters:
+    computeProgramId    Self-explanatory
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void UintSsbo::ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader)
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+
+    // see the corresponding area in ParticleSsbo::Init(...) for explanation
+    GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, bufferNameInShader.c_str());
+    if (storageBlockIndex == GL_INVALID_INDEX)
+    {
+        // compiled out of this shader (see ShaderStorage::SetPreprocessorDefines(...))
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        return;
+    }
+
+    glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _ssboBindingPointIndex);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId);
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    This SSBO does not draw.
+Parameters:
+    irrelevant
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void UintSsbo::ConfigureRender(unsigned int, unsigned int)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of unsigned integers in the buffer.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int UintSsbo::NumItems() const
+{
+    return _numItems;
+}
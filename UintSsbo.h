@@ -0,0 +1,25 @@
+#pragma once
+
+#include "SsboBase.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up a Shader Storage Block Object that is nothing but an array of unsigned integers, 
+    such as the particle indices of the "cell list" quad tree.  It will be used in the compute 
+    shader only, and the values are expected to be generated there, so the buffer starts out 
+    as all zeros.
+-----------------------------------------------------------------------------------------------*/
+class UintSsbo : public SsboBase
+{
+public:
+    UintSsbo(unsigned int numItems);
+    virtual ~UintSsbo();
+
+    void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
+    void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+
+    unsigned int NumItems() const;
+
+private:
+    unsigned int _numItems;
+};
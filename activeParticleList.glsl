@@ -0,0 +1,69 @@
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The dense list of the indices of the active particles and the indirect dispatch command 
+    that covers it, both written by activeParticleCompaction.comp (see 
+    ComputeActiveParticleCompaction).  A shader that is dispatched over the list instead of 
+    over every particle includes this file and gets its particle from 
+    ParticleIndexForInvocation(...).
+
+    The dispatch command MUST be first and MUST match the layout of glDispatchComputeIndirect's 
+    command (3 work group counts).  The number of active particles comes after it because the 
+    last work group is usually only partly full.
+
+    Only compiled in if the program defines ACTIVE_PARTICLE_LIST (see 
+    ShaderStorage::SetPreprocessorDefines(...)) so that the shaders that include this don't 
+    spend 2 storage blocks on it when it isn't used.
+
+    Binding points are relevant only to a particular shader (that is, not to the OpenGL context 
+    as a whole) and are set in the SSBO's ConfigureCompute(...) function.
+-----------------------------------------------------------------------------------------------*/
+#ifdef ACTIVE_PARTICLE_LIST
+uniform uint uUseActiveParticleList;
+
+layout (std430) buffer ActiveParticleDispatchBuffer
+{
+    uint NumWorkGroupsX;
+    uint NumWorkGroupsY;
+    uint NumWorkGroupsZ;
+    uint NumActiveParticles;
+};
+
+layout (std430) buffer ActiveParticleIndexBuffer
+{
+    uint AllActiveParticleIndices[];
+};
+#endif
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finds the particle that this invocation is working on.  With the active list, that is the 
+    invocation'th entry in the list.  Without it, the dispatch covers every particle and that 
+    is the invocation'th particle.
+
+    Note: A particle in the list can still be inactive by the time that the shader gets to it 
+    (the update shader deactivates particles that go out of bounds), so shaders still check.
+Parameters:
+    invocationIndex     gl_GlobalInvocationID.x
+    maxParticles        Self-explanatory.
+    particleIndex       Self-explanatory.
+Returns:
+    False if this invocation has no particle, otherwise true.
+-----------------------------------------------------------------------------------------------*/
+bool ParticleIndexForInvocation(uint invocationIndex, uint maxParticles, out uint particleIndex)
+{
+    particleIndex = invocationIndex;
+#ifdef ACTIVE_PARTICLE_LIST
+    if (uUseActiveParticleList == 1)
+    {
+        if (invocationIndex >= NumActiveParticles)
+        {
+            return false;
+        }
+
+        particleIndex = AllActiveParticleIndices[invocationIndex];
+        return true;
+    }
+#endif
+
+    return invocationIndex < maxParticles;
+}
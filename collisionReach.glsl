@@ -0,0 +1,32 @@
+/*-----------------------------------------------------------------------------------------------
+Description:
+    How far a particle has to look for others that it could be touching, shared by
+    quadTreeParticleCollisions.comp and quadTreeOverflowCollisions.comp so that the two passes
+    check the same leaves.  GLSL has no function pointers, so the shader that includes this
+    file says how big its particles are and how much farther it needs to look by defining these
+    before the #include:
+
+        float RadiusOfInfluence(uint particleIndex);
+        float CollisionReachPadding(uint particleIndex);
+-----------------------------------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    How far from the particle another particle's node or leaf has to be before nothing in it
+    can be touching the particle.  Two particles collide when they are the sum of their radii
+    apart, and the other particle could be of any species, so the reach is this particle's
+    radius plus the largest species' radius.  That also makes the reach symmetric enough for
+    "pair once" mode: if two particles touch, then each one reaches the other's leaf.
+
+    Anything that the including shader needs on top of that (such as how far the particles
+    moved in "swept collisions" mode) is its padding.
+Parameters:
+    particleIndex   Self-explanatory.
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+uniform float uMaxRadiusOfInfluence;
+float CollisionReach(uint particleIndex)
+{
+    return RadiusOfInfluence(particleIndex) + uMaxRadiusOfInfluence + CollisionReachPadding(particleIndex);
+}
@@ -0,0 +1,119 @@
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Counter-based random numbers (Philox4x32-10; see Random123, Salmon et al., "Parallel 
+    Random Numbers: As Easy as 1, 2, 3", 2011).  Each number is a hash of where it is in the 
+    stream: (particle index, frame number, stream, block), keyed with a seed that stays the 
+    same for the whole run.  No atomic counters, so spawning invocations don't wait on each 
+    other, and no banding from feeding sequential integers to a sin() hash.
+
+    The same generator is in RandomToast.cpp, and given the same inputs, the two give the 
+    exact same numbers.
+
+    Call SeedRandom(...) once per invocation before the first RandomOnRange0To1().  The stream 
+    lives in private globals, so each invocation has its own.
+-----------------------------------------------------------------------------------------------*/
+
+// what the numbers are for, so that two uses with the same particle and frame don't get the 
+// same numbers
+// Note: MUST match the RANDOM_STREAM values in RandomToast.h.
+const uint RANDOM_STREAM_PARTICLE_RESET = 0;
+const uint RANDOM_STREAM_POLYGON_REGION = 1;
+
+// MUST match the values in RandomToast.cpp
+const uint PHILOX_M4X32_0 = 0xD2511F53u;
+const uint PHILOX_M4X32_1 = 0xCD9E8D57u;
+const uint PHILOX_W32_0 = 0x9E3779B9u;
+const uint PHILOX_W32_1 = 0xBB67AE85u;
+
+uniform uint uRandomSeed;
+
+// particle index, frame number, stream, and which block of 4 numbers is next
+uvec4 gRandomCounter = uvec4(0);
+
+// 4 numbers come out of each hash
+uvec4 gRandomBlock = uvec4(0);
+uint gRandomNumUsedInBlock = 4;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Philox4x32 with 10 rounds.  Scrambles a 128bit counter with a 64bit key.  Each round 
+    multiplies two of the words into 64bit products and swaps the halves around, mixing in the 
+    other two words and the key.
+Parameters:
+    counter     Where the numbers are in the stream.
+    key         Which stream.
+Returns:
+    4 random unsigned ints.
+-----------------------------------------------------------------------------------------------*/
+uvec4 Philox4x32(uvec4 counter, uvec2 key)
+{
+    for (int round = 0; round < 10; round++)
+    {
+        if (round > 0)
+        {
+            key += uvec2(PHILOX_W32_0, PHILOX_W32_1);
+        }
+
+        uint hi0;
+        uint lo0;
+        uint hi1;
+        uint lo1;
+        umulExtended(PHILOX_M4X32_0, counter.x, hi0, lo0);
+        umulExtended(PHILOX_M4X32_1, counter.z, hi1, lo1);
+        counter = uvec4(hi1 ^ counter.y ^ key.x, lo1, hi0 ^ counter.w ^ key.y, lo0);
+    }
+
+    return counter;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts this invocation's stream of numbers.  The same as NewRandomStream(...) in 
+    RandomToast.cpp.
+Parameters:
+    particleIndex   Self-explanatory.
+    frameNumber     Self-explanatory.
+    streamId        One of the RANDOM_STREAM_* values.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void SeedRandom(uint particleIndex, uint frameNumber, uint streamId)
+{
+    gRandomCounter = uvec4(particleIndex, frameNumber, streamId, 0);
+    gRandomNumUsedInBlock = 4;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Hands out the stream's next number.  Every 4th call hashes the next block.
+Parameters: None
+Returns:
+    A random unsigned int.
+-----------------------------------------------------------------------------------------------*/
+uint RandomUint()
+{
+    if (gRandomNumUsedInBlock == 4)
+    {
+        gRandomBlock = Philox4x32(gRandomCounter, uvec2(uRandomSeed, 0));
+        gRandomCounter.w++;
+        gRandomNumUsedInBlock = 0;
+    }
+
+    uint value = gRandomBlock[gRandomNumUsedInBlock];
+    gRandomNumUsedInBlock++;
+    return value;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Generates a random float on the range [0,+1) from the stream's next number.
+
+    Note: Only the top 24 bits are used because that is all that a float can hold exactly, 
+    and scaling by a power of 2 is exact, so the CPU gets the same float.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+float RandomOnRange0To1()
+{
+    return float(RandomUint() >> 8) * (1.0f / 16777216.0f);
+}
@@ -0,0 +1,60 @@
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The stack of the indices of the inactive particles (see 
+    ComputeParticleReset::ShareFreeParticleStack(...)).  The update shader pushes a particle 
+    when it deactivates it, and the reset shader pops one for every particle that it emits, 
+    so emitting costs as much as the number of particles that are emitted instead of a walk 
+    through the whole particle buffer.
+
+    The count is signed because a pop takes its slot first and gives it back if there wasn't 
+    one (see PopFreeParticleIndex(...)), and for a moment the count can go below 0.
+
+    Binding points are relevant only to a particular shader (that is, not to the OpenGL context 
+    as a whole) and are set in the SSBO's ConfigureCompute(...) function.
+-----------------------------------------------------------------------------------------------*/
+layout (std430) buffer FreeParticleIndexBuffer
+{
+    int NumFreeParticles;
+    uint AllFreeParticleIndices[];
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Puts the particle on top of the stack.  A particle MUST only be pushed once each time that 
+    it becomes inactive, or the stack will hand it out twice.
+
+    Note: There is room for every particle, so this can't overflow.
+Parameters:
+    particleIndex   Self-explanatory.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void PushFreeParticleIndex(uint particleIndex)
+{
+    int slot = atomicAdd(NumFreeParticles, 1);
+    AllFreeParticleIndices[slot] = particleIndex;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Takes the particle off the top of the stack, if there is one.
+
+    Note: Pushes and pops MUST NOT happen in the same dispatch.  A pop that finds the stack 
+    empty puts its slot back, and a push in between would be written over.
+Parameters:
+    particleIndex   Self-explanatory.
+Returns:
+    False if the stack was empty (every particle is active), otherwise true.
+-----------------------------------------------------------------------------------------------*/
+bool PopFreeParticleIndex(out uint particleIndex)
+{
+    particleIndex = 0;
+    int numFreeBefore = atomicAdd(NumFreeParticles, -1);
+    if (numFreeBefore <= 0)
+    {
+        atomicAdd(NumFreeParticles, 1);
+        return false;
+    }
+
+    particleIndex = AllFreeParticleIndices[numFreeBefore - 1];
+    return true;
+}
@@ -43,15 +43,39 @@
 // for particles, where they live, and how to update them
 #include "glm/vec2.hpp"
 #include "ParticleQuadTree.h"
+#include "ParticleQuadTreeNode.h"
+#include "ParticleSpecies.h"
+#include "PolygonFace.h"
+#include "ParticleEmitterTableEntry.h"
+#include "ParticleMirror.h"
+#include "ParticleCell.h"
+#include "MortonQuadTreeLeaf.h"
 #include "ParticleSsbo.h"
+#include "ParticleSpeciesSsbo.h"
 #include "PolygonSsbo.h"
 #include "QuadTreeNodeSsbo.h"
+#include "ParticleCellSsbo.h"
+#include "UintSsbo.h"
+#include "MortonQuadTreeLeafSsbo.h"
 #include "ComputeQuadTreeReset.h"
 #include "ComputeQuadTreeGenerateGeometry.h"
 #include "ComputeParticleReset.h"
 #include "ComputeParticleUpdate.h"
 #include "ComputeQuadTreePopulate.h"
+#include "ComputeQuadTreeSubdivide.h"
+#include "ComputeQuadTreeLeafNeighbors.h"
+#include "ComputeQuadTreeIncrementalUpdate.h"
+#include "ComputeQuadTreeOverflowCollisions.h"
 #include "ComputeQuadTreeParticleCollisions.h"
+#include "ComputeCellListBuild.h"
+#include "ComputeCellListTiledCollisions.h"
+#include "ComputeRadixSort.h"
+#include "ComputeMortonQuadTreeBuild.h"
+#include "ParticleMortonQuadTree.h"
+#include "ComputeParticleReorder.h"
+#include "ComputeActiveParticleCompaction.h"
+#include "ComputeParticleVerletLists.h"
+#include "ComputeParticleContactSolver.h"
 
 // for moving the shapes around in window space
 #include "glm/gtc/matrix_transform.hpp"
@@ -60,6 +84,7 @@
 // for the frame rate counter
 #include "FreeTypeEncapsulated.h"
 #include "Stopwatch.h"
+#include "GpuStageTimer.h"
 
 Stopwatch gTimer;
 FreeTypeEncapsulated gTextAtlases;
@@ -70,9 +95,19 @@ GLint gUnifLocGeometryTransform;
 
 // ??stored in scene??
 ParticleSsbo *gpParticleBuffer = 0;
+ParticleSpeciesSsbo *gpParticleSpeciesBuffer = 0;
+UintSsbo *gpParticleMirrorBuffer = 0;
 PolygonSsbo *gpParticleBoundingRegionBuffer = 0;
 PolygonSsbo *gpQuadTreeGeometryBuffer = 0;
-QuadTreeNodeSsbo *gpQuadTreeBuffer = 0;
+QuadTreeNodeSsbo *gpQuadTreeNodeCountBuffer = 0;
+QuadTreeNodeSsbo *gpQuadTreeNodeBoundsBuffer = 0;
+QuadTreeNodeSsbo *gpQuadTreeNodeNeighborBuffer = 0;
+UintSsbo *gpQuadTreeNodeParticleIndexBuffer = 0;
+UintSsbo *gpQuadTreeLeafNeighborBuffer = 0;
+ParticleCellSsbo *gpCellBuffer = 0;
+UintSsbo *gpSortedParticleIndexBuffer = 0;
+UintSsbo *gpSortedMortonCodeBuffer = 0;
+MortonQuadTreeLeafSsbo *gpMortonLeafBuffer = 0;
 
 // in a bigger program, ??where would particle stuff be stored??
 IParticleEmitter *gpParticleEmitterBar1 = 0;
@@ -82,10 +117,169 @@ ComputeParticleUpdate *gpParticleUpdater = 0;
 ComputeQuadTreeReset *gpQuadTreeReseter = 0;
 ComputeQuadTreeGenerateGeometry *gpQuadTreeGeometryGenerator = 0;
 ComputeQuadTreePopulate *gpQuadTreePopulater = 0;
+ComputeQuadTreeSubdivide *gpQuadTreeSubdivider = 0;
+ComputeQuadTreeLeafNeighbors *gpQuadTreeLeafNeighborFinder = 0;
+ComputeQuadTreeIncrementalUpdate *gpQuadTreeIncrementalUpdater = 0;
 ComputeParticleQuadTreeCollisions *gpQuadTreeParticleCollider = 0;
+ComputeQuadTreeOverflowCollisions *gpQuadTreeOverflowCollider = 0;
+ComputeCellListBuild *gpCellListBuilder = 0;
+ComputeCellListTiledCollisions *gpCellListTiledCollider = 0;
+ComputeRadixSort *gpMortonCodeSorter = 0;
+ComputeMortonQuadTreeBuild *gpMortonQuadTreeBuilder = 0;
+ComputeParticleReorder *gpParticleReorderer = 0;
+ComputeParticleVerletLists *gpParticleVerletLists = 0;
+ComputeParticleContactSolver *gpParticleContactSolver = 0;
+ComputeActiveParticleCompaction *gpActiveParticleCompaction = 0;
+
+// how long the GPU spends on each part of UpdateAllTheThings()
+// Note: The averages are printed to the console whenever they are updated.  Compare them 
+// before and after a change to see where the time went.
+enum GPU_TIMED_STAGE
+{
+    GPU_TIMED_STAGE_PARTICLE_UPDATE = 0,    // reset and update
+    GPU_TIMED_STAGE_STRUCTURE_RESET,        // quad tree nodes only
+    GPU_TIMED_STAGE_STRUCTURE_BUILD,        // populate, cell list, or Morton quad tree
+    GPU_TIMED_STAGE_STRUCTURE_SUBDIVIDE,    // quad tree nodes only
+    GPU_TIMED_STAGE_LEAF_NEIGHBORS,         // quad tree nodes only
+    GPU_TIMED_STAGE_PARTICLE_REORDER,
+    GPU_TIMED_STAGE_COLLISIONS,
+    GPU_TIMED_STAGE_GENERATE_GEOMETRY,      // quad tree nodes only
+    GPU_TIMED_STAGE_COUNT
+};
+const char *GPU_TIMED_STAGE_NAMES[GPU_TIMED_STAGE_COUNT] = 
+{
+    "update", "reset", "build", "subdivide", "neighbors", "reorder", "collide", "geometry"
+};
+const unsigned int GPU_TIMER_FRAMES_PER_AVERAGE = 120;
+GpuStageTimer *gpGpuStageTimer = 0;
 
 const unsigned int MAX_PARTICLE_COUNT = 100000;
 
+// which structure the particles are sorted into for collision detection
+// - QUAD_TREE_NODES: nodes with fixed-size particle arrays (see ParticleQuadTree)
+// - CELL_LIST: the starting nodes as a "cell list" (see ComputeCellListBuild)
+// - MORTON_QUAD_TREE: a quad tree that falls out of sorted Morton codes (see 
+//   ParticleMortonQuadTree)
+// Note: Only the node version allocates the quad tree node buffer, so the quad tree geometry 
+// isn't generated for the others.
+const ComputeParticleQuadTreeCollisions::SpatialStructure SPATIAL_STRUCTURE = ComputeParticleQuadTreeCollisions::QUAD_TREE_NODES;
+
+// the particles are moved around in the particle buffer into node order once every this many 
+// frames so that the collision shader's reads are closer together (0 turns it off)
+// Note: Watch the "reorder saved" number on the screen.  It is paid for once per reorder 
+// (see ComputeParticleReorder::BytesMovedPerReorder()) and earned back on every walk through 
+// the nodes until the next one.  If it is small, the particles aren't drifting out of order 
+// much between reorders, and this can be bigger.
+const unsigned int PARTICLE_REORDER_INTERVAL_FRAMES = 0;
+
+// the particles are stored as one buffer per part of the particle (position, velocity, etc.) 
+// instead of one buffer of whole particles, so each shader only reads the parts that it needs 
+// (see ParticleSsbo and particleStorage.glsl)
+// Note: The particle reorder moves whole particles around in one buffer, so it is off in this 
+// mode.
+// Also Note: The collision shader uses 5 more storage blocks in this mode, so it may not fit 
+// into what the driver allows along with the optional modes (see 
+// NumCollisionShaderStorageBlocks()).
+const bool PARTICLE_STORAGE_SOA = false;
+
+// the indices of the active particles are packed into a list after the reset, and the update, 
+// populate, and collision shaders are dispatched over only that list (indirect dispatch) 
+// instead of over every particle (see ComputeActiveParticleCompaction)
+// Note: The list is rebuilt after the particle reorder moves the particles around.
+const bool ACTIVE_PARTICLE_LIST = false;
+
+// the node version of the quad tree can be kept from one frame to the next, and only the nodes 
+// that particles moved into or out of are rebuilt (see ComputeQuadTreeIncrementalUpdate)
+// Note: If more than the given fraction of the active particles moved, then the whole tree is 
+// rebuilt instead.  It is also rebuilt every so often regardless because the incremental 
+// update never merges nodes, so nodes that particles left stay subdivided until then.
+const bool QUAD_TREE_INCREMENTAL_UPDATES = false;
+const float QUAD_TREE_INCREMENTAL_MAX_MOVED_FRACTION = 0.25f;
+const unsigned int QUAD_TREE_FULL_REBUILD_INTERVAL_FRAMES = 60;
+
+// each colliding pair of particles is calculated once instead of once by each particle (see 
+// ComputeParticleQuadTreeCollisions)
+// Note: If the benchmark is on, the collision shader switches between "pair once" and 
+// per-particle every time the GPU stage timer has new averages, and each printed average is 
+// labeled with the mode that it was measured in.  Compare the "collide" times.
+const bool COLLISIONS_PAIR_ONCE = false;
+const bool COLLISION_MODE_BENCHMARK = false;
+
+// the collision shader reads the other particle's position, velocity, radius, and mass out of 
+// a compact mirror of each particle that the update shader writes, and only reads the full 
+// particle once it has found a collision (see ComputeParticleQuadTreeCollisions)
+// Note: If the benchmark is on, the collision shader switches between the mirror and the full 
+// particles every time the GPU stage timer has new averages, the same as the collision mode 
+// benchmark, and each printed average is labeled with how many bytes the particle that it 
+// read per neighbor was.  Compare the "collide" times.
+// Also Note: The tiled cell list collisions and the overflow collisions always read the full 
+// particles.
+const bool PARTICLE_MIRROR = false;
+const bool PARTICLE_MIRROR_BENCHMARK = false;
+
+// the collision shader only finds the touching pairs and appends them to a contact list, and 
+// then a second shader calculates the collisions once per contact (see 
+// ComputeParticleQuadTreeCollisions)
+// Note: Contacts past the max are counted but dropped, so watch the "contacts" number on the 
+// screen.
+const bool COLLISIONS_CONTACT_LIST = false;
+const unsigned int MAX_CONTACTS = MAX_PARTICLE_COUNT * 4;
+
+// particles that passed through each other during an update are caught by sweeping them from 
+// their previous positions to their current ones (see ComputeParticleQuadTreeCollisions)
+// Note: At the emitters' max speed and the hard-coded delta time in UpdateAllTheThings(), a 
+// particle only moves a fraction of its radius per update, so nothing passes through anything.  
+// This is what allows the delta time to go up.
+// Also Note: Overrides "pair once" and the contact list.  Only the node version of the quad 
+// tree and the Morton quad tree widen their search by how far the particles moved; the cell 
+// list looks at a fixed 9 cells, so it only catches particles that went through each other 
+// inside that.  The overflow collisions, the tiled cell list collisions, and the Verlet 
+// list build are not swept.
+const bool COLLISIONS_SWEPT = false;
+
+// particles that have been nearly still for this many updates in a row are put to sleep, and 
+// the update and collision shaders skip them until something runs into them hard enough to 
+// wake them up (see ComputeParticleUpdate::SetSleepThresholds(...))
+// Note: Small bumps aren't thrown away.  They go into the sleeping particle's velocity, and it 
+// wakes up once that is over the speed limit.
+// Also Note: The force limit is what it takes to change a particle's speed by the speed 
+// limit in one update (0.1 mass * 0.01 speed / 0.01 delta time).
+// Also Also Note: The tiled cell list collisions and the overflow collisions still run 
+// sleeping particles, which then wake themselves up if they feel enough force.
+const bool PARTICLE_SLEEP = false;
+const unsigned int PARTICLE_SLEEP_FRAMES = 30;
+const float PARTICLE_SLEEP_MAX_SPEED = 0.01f;
+const float PARTICLE_SLEEP_MAX_FORCE = 0.1f;
+
+// instead of an elastic collision per contact, the contacts are pushed apart by this many 
+// iterations of position-based non-penetration constraints (see 
+// ComputeParticleContactSolver); 0 turns the solver off
+// Note: Needs the contact list, so not used with swept collisions or the tiled cell list 
+// collisions.  The overflow collisions are still elastic.
+// Also Note: Pairs that only start overlapping during the iterations wait until the next 
+// frame's contact list.
+const unsigned int CONTACT_SOLVER_ITERATIONS = 0;
+
+// each particle keeps a list of the particles within its radius plus a "skin" distance, and 
+// the collisions are found from those lists until some particle has moved more than half the 
+// skin, at which point the spatial structure and the lists are rebuilt (see 
+// ComputeParticleVerletLists)
+// Note: The lists are built by walking the spatial structure, so the skin can only reach as 
+// far as the structure looks.  The node version of the quad tree and the Morton quad tree 
+// widen their search by the skin, but the cell list looks at a fixed 9 cells, so for it the 
+// skin is only useful while it fits inside one cell.
+// Also Note: The particle reorder only runs on frames that rebuild the lists (the lists hold 
+// particle indices), so its interval counts rebuilds instead of frames.
+// Also Also Note: Particles that spawn in between builds don't collide until the next one.  
+// Not used with the tiled cell list collisions.
+const bool VERLET_LISTS = false;
+const float VERLET_SKIN_FRACTION_OF_RADIUS = 0.5f;
+
+// the "cell list" collisions are found one cell per work group out of shared memory instead of 
+// one particle per invocation (see ComputeCellListTiledCollisions)
+// Note: Only used if the spatial structure is the cell list.
+const bool CELL_LIST_TILED_COLLISIONS = false;
+
 
 //
 ///*-----------------------------------------------------------------------------------------------
@@ -201,6 +395,47 @@ void GenerateCircle(const glm::vec4 &center, const float radius, std::vector<Pol
 //}
 //
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Counts the storage blocks that the collision shader (quadTreeParticleCollisions.comp) is 
+    compiled with for the spatial structure and modes at the top of this file.  It uses more of 
+    them than any other shader, and a shader that uses more than the driver allows 
+    (GL_MAX_COMPUTE_SHADER_STORAGE_BLOCKS, often 16) fails to link.
+
+    Note: MUST match the storage blocks in quadTreeParticleCollisions.comp and the files that 
+    it includes.
+Parameters: None
+Returns:
+    See Description.
+-----------------------------------------------------------------------------------------------*/
+unsigned int NumCollisionShaderStorageBlocks()
+{
+    // particles, species, and the "pair once" forces
+    unsigned int numStorageBlocks = (PARTICLE_STORAGE_SOA ? 6 : 1) + 2;
+
+    if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::QUAD_TREE_NODES)
+    {
+        // counts, bounds, neighbors, particle indices, and leaf neighbors
+        numStorageBlocks += 5;
+    }
+    else if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::CELL_LIST)
+    {
+        // cells and sorted particle indices
+        numStorageBlocks += 2;
+    }
+    else
+    {
+        // sorted Morton codes, sorted particle indices, and leaves
+        numStorageBlocks += 3;
+    }
+
+    numStorageBlocks += ACTIVE_PARTICLE_LIST ? 2 : 0;
+    numStorageBlocks += (PARTICLE_MIRROR || PARTICLE_MIRROR_BENCHMARK) ? 1 : 0;
+    numStorageBlocks += COLLISIONS_CONTACT_LIST ? 1 : 0;
+    numStorageBlocks += VERLET_LISTS ? 2 : 0;
+    return numStorageBlocks;
+}
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     Governs window creation, the initial OpenGL configuration (face culling, depth mask, even
@@ -240,6 +475,75 @@ void Init()
 
     ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
 
+    // MUST be set before any of the particle shaders are compiled
+    // Note: The spatial structures and optional modes that aren't in use are compiled out of 
+    // the shaders so that their storage blocks don't count against the driver's limit.
+    std::string shaderDefines;
+    if (PARTICLE_STORAGE_SOA)
+    {
+        shaderDefines += "#define PARTICLE_STORAGE_SOA\n";
+    }
+
+    if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::QUAD_TREE_NODES)
+    {
+        shaderDefines += "#define SPATIAL_STRUCTURE_QUAD_TREE_NODES\n";
+    }
+    else if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::CELL_LIST)
+    {
+        shaderDefines += "#define SPATIAL_STRUCTURE_CELL_LIST\n";
+    }
+    else
+    {
+        shaderDefines += "#define SPATIAL_STRUCTURE_MORTON_QUAD_TREE\n";
+    }
+
+    if (ACTIVE_PARTICLE_LIST)
+    {
+        shaderDefines += "#define ACTIVE_PARTICLE_LIST\n";
+    }
+
+    if (PARTICLE_MIRROR || PARTICLE_MIRROR_BENCHMARK)
+    {
+        shaderDefines += "#define PARTICLE_MIRROR\n";
+    }
+
+    if (COLLISIONS_CONTACT_LIST)
+    {
+        shaderDefines += "#define COLLISIONS_CONTACT_LIST\n";
+    }
+
+    if (VERLET_LISTS)
+    {
+        shaderDefines += "#define VERLET_LISTS\n";
+    }
+    shaderStorageRef.SetPreprocessorDefines(shaderDefines);
+
+    // the shader would just fail to link, so say why
+    GLint maxComputeStorageBlocks = 0;
+    glGetIntegerv(GL_MAX_COMPUTE_SHADER_STORAGE_BLOCKS, &maxComputeStorageBlocks);
+    unsigned int numCollisionStorageBlocks = NumCollisionShaderStorageBlocks();
+    if (numCollisionStorageBlocks > (unsigned int)maxComputeStorageBlocks)
+    {
+        printf("The collision shader needs %u storage blocks with these modes, but this driver only allows %d (GL_MAX_COMPUTE_SHADER_STORAGE_BLOCKS).  Turn some of them off.\n", 
+            numCollisionStorageBlocks, maxComputeStorageBlocks);
+    }
+
+    // the GLSL versions of the structures that the shaders share with the CPU are generated 
+    // from the C++ versions, whose layouts are checked against std430 at compile time (see 
+    // Std430Layout.h)
+    // Note: MUST be added before any shader that includes them is compiled.
+    shaderStorageRef.AddGeneratedInclude("std430/Particle.glsl", STD430_GLSL_STRUCT(Particle, PARTICLE_STD430_MEMBERS));
+    shaderStorageRef.AddGeneratedInclude("std430/ParticleSpecies.glsl", STD430_GLSL_STRUCT(ParticleSpecies, PARTICLE_SPECIES_STD430_MEMBERS));
+    shaderStorageRef.AddGeneratedInclude("std430/ParticleQuadTreeNodeCounts.glsl", STD430_GLSL_STRUCT(ParticleQuadTreeNodeCounts, PARTICLE_QUAD_TREE_NODE_COUNTS_STD430_MEMBERS));
+    shaderStorageRef.AddGeneratedInclude("std430/ParticleQuadTreeNodeBounds.glsl", STD430_GLSL_STRUCT(ParticleQuadTreeNodeBounds, PARTICLE_QUAD_TREE_NODE_BOUNDS_STD430_MEMBERS));
+    shaderStorageRef.AddGeneratedInclude("std430/ParticleQuadTreeNodeNeighbors.glsl", STD430_GLSL_STRUCT(ParticleQuadTreeNodeNeighbors, PARTICLE_QUAD_TREE_NODE_NEIGHBORS_STD430_MEMBERS));
+    shaderStorageRef.AddGeneratedInclude("std430/MyVertex.glsl", STD430_GLSL_STRUCT(MyVertex, MY_VERTEX_STD430_MEMBERS));
+    shaderStorageRef.AddGeneratedInclude("std430/ParticleEmitterTableEntry.glsl", STD430_GLSL_STRUCT(ParticleEmitterTableEntry, PARTICLE_EMITTER_TABLE_ENTRY_STD430_MEMBERS));
+    shaderStorageRef.AddGeneratedInclude("std430/PolygonFace.glsl", STD430_GLSL_STRUCT(PolygonFace, POLYGON_FACE_STD430_MEMBERS));
+    shaderStorageRef.AddGeneratedInclude("std430/ParticleMirror.glsl", STD430_GLSL_STRUCT(ParticleMirror, PARTICLE_MIRROR_STD430_MEMBERS));
+    shaderStorageRef.AddGeneratedInclude("std430/ParticleCell.glsl", STD430_GLSL_STRUCT(ParticleCell, PARTICLE_CELL_STD430_MEMBERS));
+    shaderStorageRef.AddGeneratedInclude("std430/MortonQuadTreeLeaf.glsl", STD430_GLSL_STRUCT(MortonQuadTreeLeaf, MORTON_QUAD_TREE_LEAF_STD430_MEMBERS));
+
     // FreeType initialization
     std::string freeTypeShaderKey = "freetype";
     shaderStorageRef.NewShader(freeTypeShaderKey);
@@ -265,21 +569,121 @@ void Init()
     shaderStorageRef.AddShaderFile(computeShaderQuadTreeResetKey, "quadTreeReset.comp", GL_COMPUTE_SHADER);
     shaderStorageRef.LinkShader(computeShaderQuadTreeResetKey);
 
+    std::string computeActiveParticleCompactionKey = "compute active particle compaction";
+    shaderStorageRef.NewShader(computeActiveParticleCompactionKey);
+    shaderStorageRef.AddShaderFile(computeActiveParticleCompactionKey, "activeParticleCompaction.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeActiveParticleCompactionKey);
+
     std::string computeQuadTreePopulateKey = "compute quad tree populate";
     shaderStorageRef.NewShader(computeQuadTreePopulateKey);
     shaderStorageRef.AddShaderFile(computeQuadTreePopulateKey, "quadTreePopulate.comp", GL_COMPUTE_SHADER);
     shaderStorageRef.LinkShader(computeQuadTreePopulateKey);
 
+    std::string computeQuadTreeSubdivideKey = "compute quad tree subdivide";
+    shaderStorageRef.NewShader(computeQuadTreeSubdivideKey);
+    shaderStorageRef.AddShaderFile(computeQuadTreeSubdivideKey, "quadTreeSubdivide.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeQuadTreeSubdivideKey);
+
+    std::string computeQuadTreeLeafNeighborsKey = "compute quad tree leaf neighbors";
+    shaderStorageRef.NewShader(computeQuadTreeLeafNeighborsKey);
+    shaderStorageRef.AddShaderFile(computeQuadTreeLeafNeighborsKey, "quadTreeLeafNeighbors.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeQuadTreeLeafNeighborsKey);
+
+    std::string computeQuadTreeIncrementalUpdateKey = "compute quad tree incremental update";
+    shaderStorageRef.NewShader(computeQuadTreeIncrementalUpdateKey);
+    shaderStorageRef.AddShaderFile(computeQuadTreeIncrementalUpdateKey, "quadTreeIncrementalUpdate.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeQuadTreeIncrementalUpdateKey);
+
     std::string computeQuadTreeParticleColliderKey = "compute quad tree collider";
     shaderStorageRef.NewShader(computeQuadTreeParticleColliderKey);
     shaderStorageRef.AddShaderFile(computeQuadTreeParticleColliderKey, "quadTreeParticleCollisions.comp", GL_COMPUTE_SHADER);
     shaderStorageRef.LinkShader(computeQuadTreeParticleColliderKey);
 
+    std::string computeParticleContactResponseKey = "compute particle contact response";
+    shaderStorageRef.NewShader(computeParticleContactResponseKey);
+    shaderStorageRef.AddShaderFile(computeParticleContactResponseKey, "particleContactResponse.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeParticleContactResponseKey);
+
+    std::string computeParticleContactSolverKey = "compute particle contact solver";
+    shaderStorageRef.NewShader(computeParticleContactSolverKey);
+    shaderStorageRef.AddShaderFile(computeParticleContactSolverKey, "particleContactSolver.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeParticleContactSolverKey);
+
+    std::string computeParticleVerletCheckKey = "compute particle verlet check";
+    shaderStorageRef.NewShader(computeParticleVerletCheckKey);
+    shaderStorageRef.AddShaderFile(computeParticleVerletCheckKey, "particleVerletCheck.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeParticleVerletCheckKey);
+
+    std::string computeQuadTreeOverflowColliderKey = "compute quad tree overflow collider";
+    shaderStorageRef.NewShader(computeQuadTreeOverflowColliderKey);
+    shaderStorageRef.AddShaderFile(computeQuadTreeOverflowColliderKey, "quadTreeOverflowCollisions.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeQuadTreeOverflowColliderKey);
+
     std::string computeQuadTreeGenerateGeometryKey = "compute quad tree generate geometry";
     shaderStorageRef.NewShader(computeQuadTreeGenerateGeometryKey);
     shaderStorageRef.AddShaderFile(computeQuadTreeGenerateGeometryKey, "quadTreeGenerateGeometry.comp", GL_COMPUTE_SHADER);
     shaderStorageRef.LinkShader(computeQuadTreeGenerateGeometryKey);
 
+    std::string computeCellListCountKey = "compute cell list count";
+    shaderStorageRef.NewShader(computeCellListCountKey);
+    shaderStorageRef.AddShaderFile(computeCellListCountKey, "cellListCount.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeCellListCountKey);
+
+    std::string computeCellListScanKey = "compute cell list scan";
+    shaderStorageRef.NewShader(computeCellListScanKey);
+    shaderStorageRef.AddShaderFile(computeCellListScanKey, "cellListScan.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeCellListScanKey);
+
+    std::string computeCellListScatterKey = "compute cell list scatter";
+    shaderStorageRef.NewShader(computeCellListScatterKey);
+    shaderStorageRef.AddShaderFile(computeCellListScatterKey, "cellListScatter.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeCellListScatterKey);
+
+    std::string computeCellListTiledCollisionsKey = "compute cell list tiled collisions";
+    shaderStorageRef.NewShader(computeCellListTiledCollisionsKey);
+    shaderStorageRef.AddShaderFile(computeCellListTiledCollisionsKey, "cellListTiledCollisions.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeCellListTiledCollisionsKey);
+
+    std::string computeMortonCodesKey = "compute morton codes";
+    shaderStorageRef.NewShader(computeMortonCodesKey);
+    shaderStorageRef.AddShaderFile(computeMortonCodesKey, "mortonCodes.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeMortonCodesKey);
+
+    std::string computeMortonQuadTreeLeavesKey = "compute morton quad tree leaves";
+    shaderStorageRef.NewShader(computeMortonQuadTreeLeavesKey);
+    shaderStorageRef.AddShaderFile(computeMortonQuadTreeLeavesKey, "mortonQuadTreeLeaves.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeMortonQuadTreeLeavesKey);
+
+    std::string computeRadixSortHistogramKey = "compute radix sort histogram";
+    shaderStorageRef.NewShader(computeRadixSortHistogramKey);
+    shaderStorageRef.AddShaderFile(computeRadixSortHistogramKey, "radixSortHistogram.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeRadixSortHistogramKey);
+
+    std::string computePrefixScanKey = "compute prefix scan";
+    shaderStorageRef.NewShader(computePrefixScanKey);
+    shaderStorageRef.AddShaderFile(computePrefixScanKey, "prefixScan.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computePrefixScanKey);
+
+    std::string computeRadixSortScatterKey = "compute radix sort scatter";
+    shaderStorageRef.NewShader(computeRadixSortScatterKey);
+    shaderStorageRef.AddShaderFile(computeRadixSortScatterKey, "radixSortScatter.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeRadixSortScatterKey);
+
+    std::string computeParticleReorderKeysKey = "compute particle reorder keys";
+    shaderStorageRef.NewShader(computeParticleReorderKeysKey);
+    shaderStorageRef.AddShaderFile(computeParticleReorderKeysKey, "particleReorderKeys.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeParticleReorderKeysKey);
+
+    std::string computeParticleReorderGatherKey = "compute particle reorder gather";
+    shaderStorageRef.NewShader(computeParticleReorderGatherKey);
+    shaderStorageRef.AddShaderFile(computeParticleReorderGatherKey, "particleReorderGather.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeParticleReorderGatherKey);
+
+    std::string computeParticleReorderRemapKey = "compute particle reorder remap";
+    shaderStorageRef.NewShader(computeParticleReorderRemapKey);
+    shaderStorageRef.AddShaderFile(computeParticleReorderRemapKey, "particleReorderRemap.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.LinkShader(computeParticleReorderRemapKey);
+
 
 
     // a render shader specifically for the particles (particle color may change depending on 
@@ -314,29 +718,150 @@ void Init()
     gpParticleBoundingRegionBuffer = new PolygonSsbo(particleRegionPolygonFaces);
     gpParticleBoundingRegionBuffer->ConfigureRender(renderGeometryProgramId, GL_LINES);
 
+    // set up the table of particle species for computing and rendering
+    // Note: The particles are handed out to the species in turn, and they keep their species 
+    // when they are reset, so adding a species here is all it takes to get more kinds of 
+    // particles.  The spatial structures are sized by the largest radius.
+    std::vector<ParticleSpecies> allParticleSpecies(1);
+    gpParticleSpeciesBuffer = new ParticleSpeciesSsbo(allParticleSpecies);
+    gpParticleSpeciesBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeShaderUpdateKey), "ParticleSpeciesBuffer");
+    gpParticleSpeciesBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "ParticleSpeciesBuffer");
+    gpParticleSpeciesBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeParticleContactResponseKey), "ParticleSpeciesBuffer");
+    gpParticleSpeciesBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeParticleContactSolverKey), "ParticleSpeciesBuffer");
+    gpParticleSpeciesBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeOverflowColliderKey), "ParticleSpeciesBuffer");
+    gpParticleSpeciesBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeCellListTiledCollisionsKey), "ParticleSpeciesBuffer");
+    gpParticleSpeciesBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeParticleReorderGatherKey), "ParticleSpeciesBuffer");
+    gpParticleSpeciesBuffer->ConfigureRender(shaderStorageRef.GetShaderProgram(renderParticlesShaderKey), GL_POINTS);
+
     // set up the particle SSBO for computing and rendering
     std::vector<Particle> allParticles(MAX_PARTICLE_COUNT);
-    gpParticleBuffer = new ParticleSsbo(allParticles);
+    for (size_t particleIndex = 0; particleIndex < allParticles.size(); particleIndex++)
+    {
+        allParticles[particleIndex]._speciesIndex = particleIndex % allParticleSpecies.size();
+    }
+    ParticleSsbo::StorageLayout particleStorageLayout = PARTICLE_STORAGE_SOA ? ParticleSsbo::STRUCTURE_OF_ARRAYS : ParticleSsbo::ARRAY_OF_STRUCTURES;
+    gpParticleBuffer = new ParticleSsbo(allParticles, particleStorageLayout);
     gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeShaderResetKey), "ParticleBuffer");
     gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeShaderUpdateKey), "ParticleBuffer");
+    gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeActiveParticleCompactionKey), "ParticleBuffer");
     gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreePopulateKey), "ParticleBuffer");
+    gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeIncrementalUpdateKey), "ParticleBuffer");
     gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "ParticleBuffer");
+    gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeParticleContactResponseKey), "ParticleBuffer");
+    gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeParticleContactSolverKey), "ParticleBuffer");
+    gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeParticleVerletCheckKey), "ParticleBuffer");
+    gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeOverflowColliderKey), "ParticleBuffer");
+    gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeCellListCountKey), "ParticleBuffer");
+    gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeCellListScatterKey), "ParticleBuffer");
+    gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeCellListTiledCollisionsKey), "ParticleBuffer");
+    gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeMortonCodesKey), "ParticleBuffer");
+    gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeParticleReorderKeysKey), "ParticleBuffer");
+    gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeParticleReorderGatherKey), "ParticleBuffer");
     gpParticleBuffer->ConfigureRender(shaderStorageRef.GetShaderProgram(renderParticlesShaderKey), GL_POINTS);
 
-    // set up the quad tree for computation
-    ParticleQuadTree quadTree(particleRegionCenter, particleRegionRadius);
-    gpQuadTreeBuffer = new QuadTreeNodeSsbo(quadTree._allQuadTreeNodes);
-    gpQuadTreeBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeShaderQuadTreeResetKey), "QuadTreeNodeBuffer");
-    gpQuadTreeBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreePopulateKey), "QuadTreeNodeBuffer");
-    gpQuadTreeBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "QuadTreeNodeBuffer");
-    gpQuadTreeBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeGenerateGeometryKey), "QuadTreeNodeBuffer");
+    // the compact copy of each particle for the collisions (see ParticleMirror in 
+    // particleUpdate.comp); written by the update shader and the reorder's gather shader 
+    // every time that they move particles around, so it is set up even if the collisions 
+    // don't use it
+    gpParticleMirrorBuffer = new UintSsbo(MAX_PARTICLE_COUNT * (sizeof(ParticleMirror) / sizeof(unsigned int)));
+    gpParticleMirrorBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeShaderUpdateKey), "ParticleMirrorBuffer");
+    gpParticleMirrorBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeParticleReorderGatherKey), "ParticleMirrorBuffer");
+    gpParticleMirrorBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "ParticleMirrorBuffer");
 
-    // set up the quad tree's nodes for rendering
-    unsigned int allPolygonFaces = ParticleQuadTree::_MAX_NODES * 4;
-    std::vector<PolygonFace> quadTreePolygonFaces(allPolygonFaces);
-    gpQuadTreeGeometryBuffer = new PolygonSsbo(quadTreePolygonFaces);
-    gpQuadTreeGeometryBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeGenerateGeometryKey), "QuadTreeFaceBuffer");
-    gpQuadTreeGeometryBuffer->ConfigureRender(renderGeometryProgramId, GL_LINES);
+    // set up the quad tree for computation
+    // Note: The starting grid is picked from the particles' size and count (see 
+    // ParticleQuadTree::StartingGridResolution(...)), and everything that is sized by the 
+    // number of nodes is sized from this.
+    // Also Note: The cell list is laid out like the quad tree's starting nodes, so it only 
+    // needs one cell per starting node and one sorted index per particle.
+    float particleRadiusOfInfluence = gpParticleSpeciesBuffer->MaxRadiusOfInfluence();
+    unsigned int gridResolution = ParticleQuadTree::StartingGridResolution(particleRegionRadius, particleRadiusOfInfluence, MAX_PARTICLE_COUNT);
+    ParticleQuadTree quadTree(particleRegionCenter, particleRegionRadius, gridResolution, gridResolution);
+    unsigned int allPolygonFaces = quadTree._maxNodes * 4;
+    if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::CELL_LIST)
+    {
+        std::vector<ParticleCell> allCells(quadTree._numStartingNodes);
+        gpCellBuffer = new ParticleCellSsbo(allCells);
+        gpCellBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeCellListCountKey), "CellBuffer");
+        gpCellBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeCellListScanKey), "CellBuffer");
+        gpCellBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeCellListScatterKey), "CellBuffer");
+        gpCellBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "CellBuffer");
+        gpCellBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeCellListTiledCollisionsKey), "CellBuffer");
+
+        gpSortedParticleIndexBuffer = new UintSsbo(MAX_PARTICLE_COUNT);
+        gpSortedParticleIndexBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeCellListScatterKey), "SortedParticleIndexBuffer");
+        gpSortedParticleIndexBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "SortedParticleIndexBuffer");
+        gpSortedParticleIndexBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeCellListTiledCollisionsKey), "SortedParticleIndexBuffer");
+        gpSortedParticleIndexBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeParticleReorderRemapKey), "SortedParticleIndexBuffer");
+    }
+    else if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::MORTON_QUAD_TREE)
+    {
+        // the Morton codes and particle indices are the keys and values of the radix sort, and 
+        // the sort leaves them in these same buffers
+        // Note: There can't be more leaves than particles.
+        gpSortedMortonCodeBuffer = new UintSsbo(MAX_PARTICLE_COUNT);
+        gpSortedMortonCodeBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeMortonCodesKey), "MortonCodeBuffer");
+        gpSortedMortonCodeBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeMortonQuadTreeLeavesKey), "SortedMortonCodeBuffer");
+        gpSortedMortonCodeBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "SortedMortonCodeBuffer");
+
+        gpSortedParticleIndexBuffer = new UintSsbo(MAX_PARTICLE_COUNT);
+        gpSortedParticleIndexBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeMortonCodesKey), "ParticleIndexBuffer");
+        gpSortedParticleIndexBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "SortedParticleIndexBuffer");
+        gpSortedParticleIndexBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeParticleReorderRemapKey), "SortedParticleIndexBuffer");
+
+        std::vector<MortonQuadTreeLeaf> allLeaves(MAX_PARTICLE_COUNT);
+        gpMortonLeafBuffer = new MortonQuadTreeLeafSsbo(allLeaves);
+        gpMortonLeafBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeMortonQuadTreeLeavesKey), "MortonQuadTreeLeafBuffer");
+        gpMortonLeafBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "MortonQuadTreeLeafBuffer");
+    }
+    else
+    {
+        // the nodes are split up into parts, and each shader is only given the parts that it 
+        // uses (see ParticleQuadTreeNode.h)
+        gpQuadTreeNodeCountBuffer = new QuadTreeNodeSsbo(quadTree._allNodeCounts);
+        gpQuadTreeNodeCountBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeShaderQuadTreeResetKey), "QuadTreeNodeCountBuffer");
+        gpQuadTreeNodeCountBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreePopulateKey), "QuadTreeNodeCountBuffer");
+        gpQuadTreeNodeCountBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeSubdivideKey), "QuadTreeNodeCountBuffer");
+        gpQuadTreeNodeCountBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeLeafNeighborsKey), "QuadTreeNodeCountBuffer");
+        gpQuadTreeNodeCountBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeIncrementalUpdateKey), "QuadTreeNodeCountBuffer");
+        gpQuadTreeNodeCountBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "QuadTreeNodeCountBuffer");
+        gpQuadTreeNodeCountBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeOverflowColliderKey), "QuadTreeNodeCountBuffer");
+        gpQuadTreeNodeCountBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeGenerateGeometryKey), "QuadTreeNodeCountBuffer");
+        gpQuadTreeNodeCountBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeParticleReorderRemapKey), "QuadTreeNodeCountBuffer");
+
+        gpQuadTreeNodeBoundsBuffer = new QuadTreeNodeSsbo(quadTree._allNodeBounds);
+        gpQuadTreeNodeBoundsBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreePopulateKey), "QuadTreeNodeBoundsBuffer");
+        gpQuadTreeNodeBoundsBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeSubdivideKey), "QuadTreeNodeBoundsBuffer");
+        gpQuadTreeNodeBoundsBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeLeafNeighborsKey), "QuadTreeNodeBoundsBuffer");
+        gpQuadTreeNodeBoundsBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeIncrementalUpdateKey), "QuadTreeNodeBoundsBuffer");
+        gpQuadTreeNodeBoundsBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "QuadTreeNodeBoundsBuffer");
+        gpQuadTreeNodeBoundsBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeOverflowColliderKey), "QuadTreeNodeBoundsBuffer");
+        gpQuadTreeNodeBoundsBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeGenerateGeometryKey), "QuadTreeNodeBoundsBuffer");
+
+        gpQuadTreeNodeNeighborBuffer = new QuadTreeNodeSsbo(quadTree._allNodeNeighbors);
+        gpQuadTreeNodeNeighborBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeSubdivideKey), "QuadTreeNodeNeighborBuffer");
+        gpQuadTreeNodeNeighborBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeLeafNeighborsKey), "QuadTreeNodeNeighborBuffer");
+        gpQuadTreeNodeNeighborBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "QuadTreeNodeNeighborBuffer");
+
+        gpQuadTreeNodeParticleIndexBuffer = new UintSsbo(quadTree._maxNodes * ParticleQuadTreeNodeCounts::MAX_PARTICLES_PER_QUAD_TREE_NODE);
+        gpQuadTreeNodeParticleIndexBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreePopulateKey), "QuadTreeNodeParticleIndexBuffer");
+        gpQuadTreeNodeParticleIndexBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeIncrementalUpdateKey), "QuadTreeNodeParticleIndexBuffer");
+        gpQuadTreeNodeParticleIndexBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "QuadTreeNodeParticleIndexBuffer");
+        gpQuadTreeNodeParticleIndexBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeOverflowColliderKey), "QuadTreeNodeParticleIndexBuffer");
+        gpQuadTreeNodeParticleIndexBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeParticleReorderRemapKey), "QuadTreeNodeParticleIndexBuffer");
+
+        // each leaf's list of the leaves that touch it (see ComputeQuadTreeLeafNeighbors)
+        gpQuadTreeLeafNeighborBuffer = new UintSsbo(quadTree._maxNodes * ParticleQuadTree::_LEAF_NEIGHBOR_STRIDE);
+        gpQuadTreeLeafNeighborBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeLeafNeighborsKey), "QuadTreeLeafNeighborBuffer");
+        gpQuadTreeLeafNeighborBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "QuadTreeLeafNeighborBuffer");
+        gpQuadTreeLeafNeighborBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeOverflowColliderKey), "QuadTreeLeafNeighborBuffer");
+
+        // set up the quad tree's nodes for rendering
+        std::vector<PolygonFace> quadTreePolygonFaces(allPolygonFaces);
+        gpQuadTreeGeometryBuffer = new PolygonSsbo(quadTreePolygonFaces);
+        gpQuadTreeGeometryBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeGenerateGeometryKey), "QuadTreeFaceBuffer");
+        gpQuadTreeGeometryBuffer->ConfigureRender(renderGeometryProgramId, GL_LINES);
+    }
 
 
     // put the bar emitters across from each and spraying particles toward each other and up so 
@@ -362,16 +887,93 @@ void Init()
     gpParticleReseter = new ComputeParticleReset(MAX_PARTICLE_COUNT, computeShaderResetKey);
     gpParticleReseter->AddEmitter(gpParticleEmitterBar1);
     gpParticleReseter->AddEmitter(gpParticleEmitterBar2);
+    gpParticleReseter->ShareFreeParticleStack(shaderStorageRef.GetShaderProgram(computeShaderUpdateKey));
 
     gpParticleUpdater = new ComputeParticleUpdate(MAX_PARTICLE_COUNT, particleRegionCenter, particleRegionRadius, computeShaderUpdateKey);
+    if (PARTICLE_SLEEP)
+    {
+        gpParticleUpdater->SetSleepThresholds(PARTICLE_SLEEP_FRAMES, PARTICLE_SLEEP_MAX_SPEED, PARTICLE_SLEEP_MAX_FORCE);
+    }
+
+    gpQuadTreeReseter = new ComputeQuadTreeReset(quadTree._numStartingNodes, quadTree._maxNodes, computeShaderQuadTreeResetKey);
+
+    gpQuadTreeGeometryGenerator = new ComputeQuadTreeGenerateGeometry(quadTree._maxNodes, allPolygonFaces, computeQuadTreeGenerateGeometryKey);
+
+    gpQuadTreePopulater = new ComputeQuadTreePopulate(quadTree._maxNodes, MAX_PARTICLE_COUNT, particleRegionRadius, particleRegionCenter, quadTree._numColumnsInTreeInitial, quadTree._numRowsInTreeInitial, quadTree._numStartingNodes, computeQuadTreePopulateKey);
+
+    // the collision shader only checks a node and its immediate neighbors, and two particles 
+    // touch when they are the sum of their radii apart, so a node must be at least as wide as 
+    // two of the largest species' radii or else a particle near the node's edge could touch one 
+    // that is past those neighbors.  Stop subdividing before that.
+    float nodeWidth = 2.0f * particleRegionRadius / quadTree._numColumnsInTreeInitial;
+    unsigned int maxSubdivisionLevels = 0;
+    while ((nodeWidth * 0.5f) >= 2.0f * particleRadiusOfInfluence)
+    {
+        nodeWidth *= 0.5f;
+        maxSubdivisionLevels++;
+    }
+    gpQuadTreeSubdivider = new ComputeQuadTreeSubdivide(quadTree._numStartingNodes, quadTree._maxNodes, MAX_PARTICLE_COUNT, maxSubdivisionLevels, computeQuadTreeSubdivideKey, computeQuadTreePopulateKey);
+
+    gpQuadTreeLeafNeighborFinder = new ComputeQuadTreeLeafNeighbors(quadTree._maxNodes, computeQuadTreeLeafNeighborsKey);
+
+    gpQuadTreeIncrementalUpdater = new ComputeQuadTreeIncrementalUpdate(quadTree._maxNodes, MAX_PARTICLE_COUNT, particleRegionRadius, particleRegionCenter, quadTree._numColumnsInTreeInitial, quadTree._numRowsInTreeInitial, QUAD_TREE_INCREMENTAL_MAX_MOVED_FRACTION, QUAD_TREE_FULL_REBUILD_INTERVAL_FRAMES, computeQuadTreeIncrementalUpdateKey);
+
+    unsigned int mortonCollisionLevel = ParticleMortonQuadTree::CollisionLevel(particleRegionRadius, particleRadiusOfInfluence);
+    if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::CELL_LIST)
+    {
+        gpCellListBuilder = new ComputeCellListBuild(gpCellBuffer->BufferId(), quadTree._numStartingNodes, MAX_PARTICLE_COUNT, particleRegionRadius, particleRegionCenter, quadTree._numColumnsInTreeInitial, quadTree._numRowsInTreeInitial, computeCellListCountKey, computeCellListScanKey, computeCellListScatterKey);
+        if (CELL_LIST_TILED_COLLISIONS)
+        {
+            gpCellListTiledCollider = new ComputeCellListTiledCollisions(quadTree._numStartingNodes, quadTree._numColumnsInTreeInitial, quadTree._numRowsInTreeInitial, computeCellListTiledCollisionsKey);
+        }
+    }
+    else if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::MORTON_QUAD_TREE)
+    {
+        gpMortonCodeSorter = new ComputeRadixSort(MAX_PARTICLE_COUNT, gpSortedMortonCodeBuffer, gpSortedParticleIndexBuffer, computeRadixSortHistogramKey, computePrefixScanKey, computeRadixSortScatterKey);
+        gpMortonQuadTreeBuilder = new ComputeMortonQuadTreeBuild(MAX_PARTICLE_COUNT, particleRegionRadius, particleRegionCenter, mortonCollisionLevel, gpMortonCodeSorter, computeMortonCodesKey, computeMortonQuadTreeLeavesKey);
+    }
 
-    gpQuadTreeReseter = new ComputeQuadTreeReset(ParticleQuadTree::_NUM_STARTING_NODES, ParticleQuadTree::_MAX_NODES, computeShaderQuadTreeResetKey);
+    // the node version of the quad tree keeps particle indices in the nodes, and the others 
+    // keep them in one sorted array
+    bool remapQuadTreeNodes = (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::QUAD_TREE_NODES);
+    unsigned int numItemsToRemap = remapQuadTreeNodes ? quadTree._maxNodes : MAX_PARTICLE_COUNT;
+    if (PARTICLE_REORDER_INTERVAL_FRAMES > 0 && !PARTICLE_STORAGE_SOA)
+    {
+        gpParticleReorderer = new ComputeParticleReorder(MAX_PARTICLE_COUNT, gpParticleBuffer->BufferId(), remapQuadTreeNodes, numItemsToRemap, PARTICLE_REORDER_INTERVAL_FRAMES, computeParticleReorderKeysKey, computeParticleReorderGatherKey, computeParticleReorderRemapKey, computeRadixSortHistogramKey, computePrefixScanKey, computeRadixSortScatterKey);
+    }
 
-    gpQuadTreeGeometryGenerator = new ComputeQuadTreeGenerateGeometry(ParticleQuadTree::_MAX_NODES, allPolygonFaces, computeQuadTreeGenerateGeometryKey);
+    gpQuadTreeOverflowCollider = new ComputeQuadTreeOverflowCollisions(quadTree._maxNodes, MAX_PARTICLE_COUNT, MAX_PARTICLE_COUNT, particleRadiusOfInfluence, computeQuadTreeOverflowColliderKey);
 
-    gpQuadTreePopulater = new ComputeQuadTreePopulate(ParticleQuadTree::_MAX_NODES, MAX_PARTICLE_COUNT, particleRegionRadius, particleRegionCenter, ParticleQuadTree::_NUM_COLUMNS_IN_TREE_INITIAL, ParticleQuadTree::_NUM_ROWS_IN_TREE_INITIAL, ParticleQuadTree::_NUM_STARTING_NODES, computeQuadTreePopulateKey);
+    gpQuadTreeParticleCollider = new ComputeParticleQuadTreeCollisions(MAX_PARTICLE_COUNT, MAX_CONTACTS, quadTree._numColumnsInTreeInitial, quadTree._numRowsInTreeInitial, particleRegionRadius, particleRegionCenter, particleRadiusOfInfluence, computeQuadTreeParticleColliderKey, computeParticleContactResponseKey);
+    gpQuadTreeParticleCollider->SetPairOnce(COLLISIONS_PAIR_ONCE);
+    gpQuadTreeParticleCollider->SetContactList(COLLISIONS_CONTACT_LIST);
+    gpQuadTreeParticleCollider->SetSweptCollisions(COLLISIONS_SWEPT, maxVel);
+    gpQuadTreeParticleCollider->SetSleepingParticles(PARTICLE_SLEEP);
+    gpQuadTreeParticleCollider->SetParticleMirror(PARTICLE_MIRROR);
 
-    gpQuadTreeParticleCollider = new ComputeParticleQuadTreeCollisions(MAX_PARTICLE_COUNT, computeQuadTreeParticleColliderKey);
+    if (CONTACT_SOLVER_ITERATIONS > 0 && COLLISIONS_CONTACT_LIST && !COLLISIONS_SWEPT && 
+        gpCellListTiledCollider == 0)
+    {
+        gpParticleContactSolver = new ComputeParticleContactSolver(MAX_PARTICLE_COUNT, MAX_CONTACTS, CONTACT_SOLVER_ITERATIONS, computeParticleContactSolverKey);
+        gpQuadTreeParticleCollider->ShareContactBuffer(gpParticleContactSolver->ComputeProgramId());
+        gpQuadTreeParticleCollider->SetContactResponse(false);
+    }
+
+    if (VERLET_LISTS && gpCellListTiledCollider == 0)
+    {
+        float verletSkinDistance = particleRadiusOfInfluence * VERLET_SKIN_FRACTION_OF_RADIUS;
+        gpParticleVerletLists = new ComputeParticleVerletLists(MAX_PARTICLE_COUNT, verletSkinDistance, computeParticleVerletCheckKey, computeQuadTreeParticleColliderKey);
+    }
+
+    if (ACTIVE_PARTICLE_LIST)
+    {
+        gpActiveParticleCompaction = new ComputeActiveParticleCompaction(MAX_PARTICLE_COUNT, computeActiveParticleCompactionKey);
+        gpParticleUpdater->SetActiveParticleList(gpActiveParticleCompaction);
+        gpQuadTreePopulater->SetActiveParticleList(gpActiveParticleCompaction);
+        gpQuadTreeParticleCollider->SetActiveParticleList(gpActiveParticleCompaction);
+    }
+
+    gpGpuStageTimer = new GpuStageTimer(GPU_TIMED_STAGE_COUNT, GPU_TIMER_FRAMES_PER_AVERAGE);
 
     // the timer will be used for framerate calculations
     gTimer.Init();
@@ -397,25 +999,88 @@ void UpdateAllTheThings()
     // (for this particle region and the emitters' min-max spawn velocities) at ~45,000 active 
     // particles in one moment.
     // Also Note: 50 easily maxes out the maximuum 100,000 total particles active at one time.
+    gpGpuStageTimer->StartFrame();
     gpParticleReseter->ResetParticles(5);
+    if (gpActiveParticleCompaction != 0)
+    {
+        gpActiveParticleCompaction->CompactActiveParticles();
+    }
     gpParticleUpdater->Update(deltaTimeSec);
+    gpGpuStageTimer->EndStage(GPU_TIMED_STAGE_PARTICLE_UPDATE);
 
-    gpQuadTreeReseter->ResetQuadTree();
-    gpQuadTreePopulater->PopulateTree();
+    // in "Verlet list" mode, the spatial structure is only needed to rebuild the lists
+    bool rebuildStructure = (gpParticleVerletLists == 0) || gpParticleVerletLists->ListsNeedRebuild();
+    if (!rebuildStructure)
+    {
+        // the lists are still good, so leave the structure alone
+    }
+    else if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::CELL_LIST)
+    {
+        gpCellListBuilder->BuildCellList();
+        gpGpuStageTimer->EndStage(GPU_TIMED_STAGE_STRUCTURE_BUILD);
+    }
+    else if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::MORTON_QUAD_TREE)
+    {
+        gpMortonQuadTreeBuilder->BuildTree();
+        gpGpuStageTimer->EndStage(GPU_TIMED_STAGE_STRUCTURE_BUILD);
+    }
+    else if (QUAD_TREE_INCREMENTAL_UPDATES && 
+        gpQuadTreeIncrementalUpdater->UpdateTree(gpParticleUpdater->NumActiveParticles()))
+    {
+        // only the nodes that particles moved into or out of were rebuilt, and only they can 
+        // need subdividing
+        gpGpuStageTimer->EndStage(GPU_TIMED_STAGE_STRUCTURE_BUILD);
+        gpQuadTreeSubdivider->SubdivideTree(true);
+        gpGpuStageTimer->EndStage(GPU_TIMED_STAGE_STRUCTURE_SUBDIVIDE);
+        gpQuadTreeLeafNeighborFinder->FindLeafNeighbors();
+        gpGpuStageTimer->EndStage(GPU_TIMED_STAGE_LEAF_NEIGHBORS);
+    }
+    else
+    {
+        gpQuadTreeReseter->ResetQuadTree();
+        gpGpuStageTimer->EndStage(GPU_TIMED_STAGE_STRUCTURE_RESET);
+        gpQuadTreePopulater->PopulateTree();
+        gpGpuStageTimer->EndStage(GPU_TIMED_STAGE_STRUCTURE_BUILD);
+        gpQuadTreeSubdivider->SubdivideTree(false);
+        gpGpuStageTimer->EndStage(GPU_TIMED_STAGE_STRUCTURE_SUBDIVIDE);
+        gpQuadTreeLeafNeighborFinder->FindLeafNeighbors();
+        gpGpuStageTimer->EndStage(GPU_TIMED_STAGE_LEAF_NEIGHBORS);
+    }
+
+    // only does anything once every so many frames
+    if (gpParticleReorderer != 0 && rebuildStructure)
+    {
+        bool particlesMoved = gpParticleReorderer->ReorderParticles();
+        if (particlesMoved)
+        {
+            // the free stack and the active list hold the particles' old indices
+            gpParticleReseter->RebuildFreeParticleStack();
+            if (gpActiveParticleCompaction != 0)
+            {
+                gpActiveParticleCompaction->CompactActiveParticles();
+            }
+        }
+    }
+    gpGpuStageTimer->EndStage(GPU_TIMED_STAGE_PARTICLE_REORDER);
+
+    if (gpParticleVerletLists != 0 && rebuildStructure)
+    {
+        gpParticleVerletLists->BuildLists();
+    }
 
 
     ////GLuint bufferSizeBytes = sizeof(Particle) * MAX_PARTICLE_COUNT;
-    //GLuint bufferSizeBytes = sizeof(ParticleQuadTreeNode) * ParticleQuadTree::_MAX_NODES;
+    //GLuint bufferSizeBytes = sizeof(ParticleQuadTreeNodeCounts) * ParticleQuadTree::_MAX_NODES;
     //GLuint copyBufferId;
     //glGenBuffers(1, &copyBufferId);
     //glBindBuffer(GL_COPY_WRITE_BUFFER, copyBufferId);
     //glBufferData(GL_COPY_WRITE_BUFFER, bufferSizeBytes, 0, GL_DYNAMIC_COPY);
     ////glBindBuffer(GL_COPY_READ_BUFFER, gpParticleBuffer->BufferId());
-    //glBindBuffer(GL_COPY_READ_BUFFER, gpQuadTreeBuffer->BufferId());
+    //glBindBuffer(GL_COPY_READ_BUFFER, gpQuadTreeNodeCountBuffer->BufferId());
     //glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, bufferSizeBytes);
     //void *bufferPtr = glMapBuffer(GL_COPY_WRITE_BUFFER, GL_READ_ONLY);
     ////Particle *objPtr = static_cast<Particle *>(bufferPtr);
-    //ParticleQuadTreeNode *objPtr = static_cast<ParticleQuadTreeNode *>(bufferPtr);
+    //ParticleQuadTreeNodeCounts *objPtr = static_cast<ParticleQuadTreeNodeCounts *>(bufferPtr);
     //
     ////for (size_t i = 0; i < MAX_PARTICLE_COUNT; i++)
     ////{
@@ -427,9 +1092,9 @@ void UpdateAllTheThings()
     ////}
     //for (size_t i = 0; i < ParticleQuadTree::_MAX_NODES; i++)
     //{
-    //    ParticleQuadTreeNode &node = objPtr[i];
+    //    ParticleQuadTreeNodeCounts &node = objPtr[i];
     //    if (node._numCurrentParticles == -1 ||
-    //        node._numCurrentParticles > ParticleQuadTreeNode::MAX_PARTICLES_PER_QUAD_TREE_NODE)
+    //        node._numCurrentParticles > ParticleQuadTreeNodeCounts::MAX_PARTICLES_PER_QUAD_TREE_NODE)
     //    {
     //        printf("");
     //    }
@@ -443,8 +1108,70 @@ void UpdateAllTheThings()
     
 
 
-    gpQuadTreeParticleCollider->Update(deltaTimeSec);
-    gpQuadTreeGeometryGenerator->GenerateGeometry();
+    if (gpCellListTiledCollider != 0)
+    {
+        gpCellListTiledCollider->Update(deltaTimeSec);
+    }
+    else
+    {
+        gpQuadTreeParticleCollider->Update(deltaTimeSec);
+        if (gpParticleContactSolver != 0)
+        {
+            gpParticleContactSolver->Solve(gpQuadTreeParticleCollider->NumContacts(), deltaTimeSec);
+        }
+    }
+    if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::QUAD_TREE_NODES)
+    {
+        // particles that didn't fit into their leaf
+        gpQuadTreeOverflowCollider->Update(deltaTimeSec);
+    }
+    gpGpuStageTimer->EndStage(GPU_TIMED_STAGE_COLLISIONS);
+    if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::QUAD_TREE_NODES)
+    {
+        gpQuadTreeGeometryGenerator->GenerateGeometry();
+        gpGpuStageTimer->EndStage(GPU_TIMED_STAGE_GENERATE_GEOMETRY);
+    }
+    gpGpuStageTimer->EndFrame();
+
+    if (gpGpuStageTimer->HaveNewAverages())
+    {
+        const char *collisionMode = gpQuadTreeParticleCollider->PairOnce() ? "pair once" : "per particle";
+        if (gpCellListTiledCollider != 0)
+        {
+            collisionMode = "tiled";
+        }
+        if (COLLISIONS_SWEPT && gpCellListTiledCollider == 0)
+        {
+            collisionMode = "swept";
+        }
+        if (gpParticleContactSolver != 0)
+        {
+            collisionMode = "contact solver";
+        }
+        unsigned int bytesPerNeighbor = gpQuadTreeParticleCollider->ParticleMirror() ? sizeof(ParticleMirror) : sizeof(Particle);
+        if (gpCellListTiledCollider != 0)
+        {
+            bytesPerNeighbor = sizeof(Particle);
+        }
+        printf("GPU ms per frame (%s%s, %u B per neighbor):", collisionMode, 
+            (COLLISIONS_CONTACT_LIST && !COLLISIONS_SWEPT && gpCellListTiledCollider == 0) ? ", contact list" : "", 
+            bytesPerNeighbor);
+        for (unsigned int stageIndex = 0; stageIndex < GPU_TIMED_STAGE_COUNT; stageIndex++)
+        {
+            printf("  %s %.3lf", GPU_TIMED_STAGE_NAMES[stageIndex], gpGpuStageTimer->StageMilliseconds(stageIndex));
+        }
+        printf("  (total %.3lf)\n", gpGpuStageTimer->TotalMilliseconds());
+
+        if (COLLISION_MODE_BENCHMARK)
+        {
+            gpQuadTreeParticleCollider->SetPairOnce(!gpQuadTreeParticleCollider->PairOnce());
+        }
+
+        if (PARTICLE_MIRROR_BENCHMARK)
+        {
+            gpQuadTreeParticleCollider->SetParticleMirror(!gpQuadTreeParticleCollider->ParticleMirror());
+        }
+    }
 
     // tell glut to call this display() function again on the next iteration of the main loop
     // Note: https://www.opengl.org/discussion_boards/showthread.php/168717-I-dont-understand-what-glutPostRedisplay()-does
@@ -499,7 +1226,7 @@ void Display()
 
     // draw the frame rate once per second in the lower left corner
     GLfloat color[4] = { 0.5f, 0.5f, 0.0f, 1.0f };
-    char str[32];
+    char str[64];
     static int elapsedFramesPerSecond = 0;
     static double elapsedTime = 0.0;
     static double frameRate = 0.0;
@@ -524,15 +1251,79 @@ void Display()
 
     // now show number of active particles
     // Note: For some reason, lower case "i" seems to appear too close to the other letters.
-    sprintf(str, "active: %d", gpParticleUpdater->NumActiveParticles());
+    if (PARTICLE_SLEEP)
+    {
+        unsigned int numActive = gpParticleUpdater->NumActiveParticles();
+        unsigned int numAsleep = gpParticleUpdater->NumAsleepParticles();
+        snprintf(str, sizeof(str), "active: %u (awake: %u asleep: %u)", numActive, numActive - numAsleep, numAsleep);
+    }
+    else
+    {
+        sprintf(str, "active: %d", gpParticleUpdater->NumActiveParticles());
+    }
     float numActiveParticlesXY[2] = { -0.99f, +0.7f };
     gTextAtlases.GetAtlas(48)->RenderText(str, numActiveParticlesXY, scaleXY, color);
 
     // now draw the number of active quad tree nodes
-    sprintf(str, "nodes: %d", gpQuadTreeGeometryGenerator->NumActiveFaces());
+    if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::CELL_LIST)
+    {
+        sprintf(str, "cells: %d", gpCellListBuilder->NumCells());
+    }
+    else if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::MORTON_QUAD_TREE)
+    {
+        sprintf(str, "leaves: %d depth: %d", gpMortonQuadTreeBuilder->NumLeaves(), gpMortonQuadTreeBuilder->DeepestLevel());
+    }
+    else
+    {
+        sprintf(str, "nodes: %d overflow: %d", gpQuadTreeSubdivider->NumActiveNodes(), gpQuadTreeOverflowCollider->NumOverflowParticles());
+    }
     float numActiveNodesXY[2] = { -0.99f, +0.5f };
     gTextAtlases.GetAtlas(48)->RenderText(str, numActiveNodesXY, scaleXY, color);
 
+    // and the memory traffic that the last particle reorder saved per walk through the nodes
+    unsigned int reorderBytesSaved = (gpParticleReorderer != 0) ? gpParticleReorderer->BytesSavedPerWalk() : 0;
+    sprintf(str, "reorder saved: %d KB", reorderBytesSaved / 1024);
+    float reorderSavingsXY[2] = { -0.99f, +0.3f };
+    gTextAtlases.GetAtlas(48)->RenderText(str, reorderSavingsXY, scaleXY, color);
+
+    // and how many particles changed nodes this frame, and what the tree did about it
+    if (SPATIAL_STRUCTURE == ComputeParticleQuadTreeCollisions::QUAD_TREE_NODES && 
+        QUAD_TREE_INCREMENTAL_UPDATES)
+    {
+        sprintf(str, "moved: %d (%s)", gpQuadTreeIncrementalUpdater->NumMovedParticles(), 
+            gpQuadTreeIncrementalUpdater->DidFullRebuild() ? "rebuilt" : "incremental");
+        float numMovedParticlesXY[2] = { -0.99f, +0.1f };
+        gTextAtlases.GetAtlas(48)->RenderText(str, numMovedParticlesXY, scaleXY, color);
+    }
+
+    // and how many touching pairs the collision shader found
+    if (COLLISIONS_CONTACT_LIST && gpCellListTiledCollider == 0)
+    {
+        sprintf(str, "contacts: %d", gpQuadTreeParticleCollider->NumContacts());
+        float numContactsXY[2] = { -0.99f, -0.1f };
+        gTextAtlases.GetAtlas(48)->RenderText(str, numContactsXY, scaleXY, color);
+    }
+
+    // and how far the contact solver got
+    if (gpParticleContactSolver != 0)
+    {
+        unsigned int lastIteration = gpParticleContactSolver->NumIterations() - 1;
+        snprintf(str, sizeof(str), "overlaps: %u -> %u (max %.4f)", 
+            gpParticleContactSolver->NumPenetratingContacts(0), 
+            gpParticleContactSolver->NumPenetratingContacts(lastIteration), 
+            gpParticleContactSolver->MaxPenetration(lastIteration));
+        float solverStatsXY[2] = { -0.99f, -0.5f };
+        gTextAtlases.GetAtlas(48)->RenderText(str, solverStatsXY, scaleXY, color);
+    }
+
+    // and how long the Verlet lists are lasting
+    if (gpParticleVerletLists != 0)
+    {
+        snprintf(str, sizeof(str), "verlet: %.1f frames, %.0f%% reused", gpParticleVerletLists->AverageFramesBetweenBuilds(), gpParticleVerletLists->ReuseRate() * 100.0f);
+        float verletStatsXY[2] = { -0.99f, -0.3f };
+        gTextAtlases.GetAtlas(48)->RenderText(str, verletStatsXY, scaleXY, color);
+    }
+
 
     // clean up bindings
     glUseProgram(0);
@@ -633,16 +1424,40 @@ Creator:    John Cox (2-13-2016)
 void CleanupAll()
 {
     delete gpParticleBuffer;
+    delete gpParticleSpeciesBuffer;
+    delete gpParticleMirrorBuffer;
     delete gpParticleBoundingRegionBuffer;
     delete gpQuadTreeGeometryBuffer;
-    delete gpQuadTreeBuffer;
+    delete gpQuadTreeNodeCountBuffer;
+    delete gpQuadTreeNodeBoundsBuffer;
+    delete gpQuadTreeNodeNeighborBuffer;
+    delete gpQuadTreeNodeParticleIndexBuffer;
+    delete gpQuadTreeLeafNeighborBuffer;
     delete gpParticleEmitterBar1;
     delete gpParticleEmitterBar2;
     delete gpParticleReseter;
     delete gpParticleUpdater;
     delete gpQuadTreePopulater;
+    delete gpQuadTreeSubdivider;
+    delete gpQuadTreeLeafNeighborFinder;
+    delete gpQuadTreeIncrementalUpdater;
+    delete gpQuadTreeParticleCollider;
+    delete gpQuadTreeOverflowCollider;
     delete gpQuadTreeReseter;
     delete gpQuadTreeGeometryGenerator;
+    delete gpCellBuffer;
+    delete gpSortedParticleIndexBuffer;
+    delete gpCellListBuilder;
+    delete gpCellListTiledCollider;
+    delete gpMortonQuadTreeBuilder;
+    delete gpMortonCodeSorter;
+    delete gpSortedMortonCodeBuffer;
+    delete gpMortonLeafBuffer;
+    delete gpParticleReorderer;
+    delete gpParticleVerletLists;
+    delete gpParticleContactSolver;
+    delete gpActiveParticleCompaction;
+    delete gpGpuStageTimer;
 }
 
 /*-----------------------------------------------------------------------------------------------
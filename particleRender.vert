@@ -8,10 +8,21 @@ layout (location = 0) in vec4 pos;
 layout (location = 1) in vec4 vel;  
 layout (location = 2) in vec4 netForce;
 layout (location = 3) in int collisionCountThisFrame;
-layout (location = 4) in float mass;
-layout (location = 5) in float radiusOfInfluence;
-layout (location = 6) in uint indexOfNodeThatItIsOccupying;
-layout (location = 7) in int isActive;
+layout (location = 4) in uint speciesIndex;
+layout (location = 5) in uint indexOfNodeThatItIsOccupying;
+layout (location = 6) in int isActive;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The table of particle species, for the species' color.  Generated from the version on the 
+    CPU side (see Std430Layout.h).  The binding is set up in ParticleSpeciesSsbo::ConfigureRender(...).
+-----------------------------------------------------------------------------------------------*/
+#include "std430/ParticleSpecies.glsl"
+
+layout (std430) buffer ParticleSpeciesBuffer
+{
+    ParticleSpecies AllParticleSpecies[];
+};
 
 // must have the same name as its corresponding "in" item in the frag shader
 smooth out vec4 particleColor;
@@ -61,7 +72,8 @@ void main()
             red = fraction;
         }
 
-        particleColor = vec4(red, green, blue, 1.0f);
+        // the species' color tints the "collision count" color
+        particleColor = vec4(red, green, blue, 1.0f) * AllParticleSpecies[speciesIndex]._color;
         
 //        //                            2147483647
 //        //
@@ -70,7 +82,7 @@ void main()
 //        // AllParticles[particleIndex]._collisionCountThisFrame = 1 --> collisionCountThisFrame == 1065353216 --> 0b0111111100000000000000000000000
 //        //                            1075838976
 //        if (collisionCountThisFrame == 3)
-//        //if (mass == 0.1f)
+//        //if (speciesIndex == 0)
 //        //if (indexOfNodeThatItIsOccupying == 13)
 //        {
 //            particleColor = vec4(0.0f, 1.0f, 0.0f, 1.0f);
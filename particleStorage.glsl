@@ -0,0 +1,164 @@
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Stores info about a single particle.  The structure itself is generated from the version 
+    on the CPU side (see Std430Layout.h).
+
+    Every shader that works on particles includes this file (ShaderStorage expands the 
+    #include) so that the way that the particles are stored is only written out once.  
+    Shaders MUST get at the particles through the PARTICLE_*(index) macros, or 
+    LoadParticle(...) and StoreParticle(...), and never through the buffers directly, because 
+    the buffers depend on the storage layout.
+Creator: John Cox (9-25-2016)
+-----------------------------------------------------------------------------------------------*/
+#include "std430/Particle.glsl"
+
+#ifdef PARTICLE_STORAGE_SOA
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    "Structure of arrays" storage (see ParticleSsbo).  Each part of the particle has its own 
+    buffer, so a shader only reads the parts that it uses, and those are packed tightly 
+    together instead of being a whole particle apart.  The small values that are usually read 
+    together share a buffer.  MUST match the versions on the CPU side (see ParticleSsbo.cpp).
+
+    Binding points are relevant only to a particular shader (that is, not to the OpenGL context 
+    as a whole) and are set in the SSBO's ConfigureCompute(...) function.  A buffer that a 
+    shader doesn't use isn't active in that shader, so it isn't bound.
+-----------------------------------------------------------------------------------------------*/
+struct ParticleState
+{
+    int _collisionCountThisFrame;
+    uint _speciesIndex;
+    int _isActive;
+    float _timeOfImpact;
+    uint _framesAtRest;
+};
+
+layout (std430) buffer ParticlePositionBuffer
+{
+    vec4 AllParticlePositions[];
+};
+
+layout (std430) buffer ParticleVelocityBuffer
+{
+    vec4 AllParticleVelocities[];
+};
+
+layout (std430) buffer ParticleForceBuffer
+{
+    vec4 AllParticleForces[];
+};
+
+layout (std430) buffer ParticlePreviousPositionBuffer
+{
+    vec2 AllParticlePreviousPositions[];
+};
+
+layout (std430) buffer ParticleStateBuffer
+{
+    ParticleState AllParticleStates[];
+};
+
+layout (std430) buffer ParticleNodeIndexBuffer
+{
+    uint AllParticleNodeIndices[];
+};
+
+#define PARTICLE_POS(index) AllParticlePositions[index]
+#define PARTICLE_VEL(index) AllParticleVelocities[index]
+#define PARTICLE_NET_FORCE(index) AllParticleForces[index]
+#define PARTICLE_PREV_POS(index) AllParticlePreviousPositions[index]
+#define PARTICLE_COLLISION_COUNT(index) AllParticleStates[index]._collisionCountThisFrame
+#define PARTICLE_SPECIES_INDEX(index) AllParticleStates[index]._speciesIndex
+#define PARTICLE_NODE_INDEX(index) AllParticleNodeIndices[index]
+#define PARTICLE_IS_ACTIVE(index) AllParticleStates[index]._isActive
+#define PARTICLE_TIME_OF_IMPACT(index) AllParticleStates[index]._timeOfImpact
+#define PARTICLE_FRAMES_AT_REST(index) AllParticleStates[index]._framesAtRest
+
+#else
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    "Array of structures" storage: the SSBO that contains all the particles that this 
+    simulation is running.  Rather self-explanatory.
+
+    Binding points are relevant only to a particular shader (that is, not to the OpenGL context 
+    as a whole) and are set in the SSBO's ConfigureCompute(...) function.
+Creator: John Cox (9-25-2016)
+-----------------------------------------------------------------------------------------------*/
+layout (std430) buffer ParticleBuffer
+{
+    Particle AllParticles[];
+};
+
+#define PARTICLE_POS(index) AllParticles[index]._pos
+#define PARTICLE_VEL(index) AllParticles[index]._vel
+#define PARTICLE_NET_FORCE(index) AllParticles[index]._netForceThisFrame
+#define PARTICLE_PREV_POS(index) AllParticles[index]._prevPos
+#define PARTICLE_COLLISION_COUNT(index) AllParticles[index]._collisionCountThisFrame
+#define PARTICLE_SPECIES_INDEX(index) AllParticles[index]._speciesIndex
+#define PARTICLE_NODE_INDEX(index) AllParticles[index]._indexOfNodeThatItIsOccupying
+#define PARTICLE_IS_ACTIVE(index) AllParticles[index]._isActive
+#define PARTICLE_TIME_OF_IMPACT(index) AllParticles[index]._timeOfImpact
+#define PARTICLE_FRAMES_AT_REST(index) AllParticles[index]._framesAtRest
+
+#endif
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Reads the whole particle.  Only for shaders that need (nearly) all of it; the others 
+    should use the PARTICLE_*(index) macros so that the "structure of arrays" storage doesn't 
+    read the parts that they don't need.
+Parameters:
+    index   Self-explanatory.
+Returns:
+    A copy of the particle.
+-----------------------------------------------------------------------------------------------*/
+Particle LoadParticle(uint index)
+{
+#ifdef PARTICLE_STORAGE_SOA
+    Particle p;
+    p._pos = PARTICLE_POS(index);
+    p._vel = PARTICLE_VEL(index);
+    p._netForceThisFrame = PARTICLE_NET_FORCE(index);
+    p._prevPos = PARTICLE_PREV_POS(index);
+    ParticleState state = AllParticleStates[index];
+    p._collisionCountThisFrame = state._collisionCountThisFrame;
+    p._speciesIndex = state._speciesIndex;
+    p._indexOfNodeThatItIsOccupying = PARTICLE_NODE_INDEX(index);
+    p._isActive = state._isActive;
+    p._timeOfImpact = state._timeOfImpact;
+    p._framesAtRest = state._framesAtRest;
+    return p;
+#else
+    return AllParticles[index];
+#endif
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Writes the whole particle.  Same idea as LoadParticle(...).
+Parameters:
+    index   Self-explanatory.
+    p       Self-explanatory.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void StoreParticle(uint index, Particle p)
+{
+#ifdef PARTICLE_STORAGE_SOA
+    PARTICLE_POS(index) = p._pos;
+    PARTICLE_VEL(index) = p._vel;
+    PARTICLE_NET_FORCE(index) = p._netForceThisFrame;
+    PARTICLE_PREV_POS(index) = p._prevPos;
+    ParticleState state;
+    state._collisionCountThisFrame = p._collisionCountThisFrame;
+    state._speciesIndex = p._speciesIndex;
+    state._isActive = p._isActive;
+    state._timeOfImpact = p._timeOfImpact;
+    state._framesAtRest = p._framesAtRest;
+    AllParticleStates[index] = state;
+    PARTICLE_NODE_INDEX(index) = p._indexOfNodeThatItIsOccupying;
+#else
+    AllParticles[index] = p;
+#endif
+}
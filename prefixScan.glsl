@@ -0,0 +1,80 @@
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The chunked, single work group exclusive prefix scan that is shared by prefixScan.comp and 
+    cellListScan.comp.  GLSL has no function pointers, so the shader that includes this file 
+    says where the values come from and where the sums go by defining these before the 
+    #include:
+
+        const uint WORK_GROUP_SIZE = ...;   (and the matching layout(local_size_x = ...))
+        uint PrefixScanLoad(uint itemIndex);
+        void PrefixScanStore(uint itemIndex, uint exclusiveSum);
+
+    Then main() calls PrefixScan(<number of items>) from every invocation in the work group.
+-----------------------------------------------------------------------------------------------*/
+
+// one running sum per invocation; shared by the whole work group
+shared uint sPartialSums[WORK_GROUP_SIZE];
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Waits until every invocation in the work group has reached this point and until their 
+    writes to shared memory are visible to each other.
+Parameters: None
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void SharedMemorySync()
+{
+    memoryBarrierShared();
+    barrier();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    There is only one work group, and it walks through the items one chunk of WORK_GROUP_SIZE 
+    items at a time.
+
+    For each chunk, the work group does an inclusive prefix sum in shared memory 
+    (Hillis-Steele: at each step, every invocation adds in the sum from "offset" slots before 
+    it, and the offset doubles each step).  Subtracting an item's own value turns that into an 
+    exclusive sum, and adding the total of all the previous chunks turns it into the sum of 
+    every item before it.
+
+    Note: A single work group keeps this to one dispatch.  It is plenty for arrays of a few 
+    thousand items, but it would have to become a multi-level scan for arrays with millions.
+    Also Note: Every invocation MUST call this (there are barriers inside), and the loop's trip 
+    count depends only on numItems, so none of them skip a barrier.
+Parameters:
+    numItems    Self-explanatory.
+Returns:    None
+-----------------------------------------------------------------------------------------------*/
+void PrefixScan(uint numItems)
+{
+    uint localIndex = gl_LocalInvocationID.x;
+    uint previousChunksTotal = 0;
+
+    for (uint chunkStart = 0; chunkStart < numItems; chunkStart += WORK_GROUP_SIZE)
+    {
+        uint itemIndex = chunkStart + localIndex;
+        uint value = (itemIndex < numItems) ? PrefixScanLoad(itemIndex) : 0;
+        sPartialSums[localIndex] = value;
+        SharedMemorySync();
+
+        for (uint offset = 1; offset < WORK_GROUP_SIZE; offset *= 2)
+        {
+            // read everything before anyone writes
+            uint addThis = (localIndex >= offset) ? sPartialSums[localIndex - offset] : 0;
+            SharedMemorySync();
+            sPartialSums[localIndex] += addThis;
+            SharedMemorySync();
+        }
+
+        if (itemIndex < numItems)
+        {
+            PrefixScanStore(itemIndex, previousChunksTotal + sPartialSums[localIndex] - value);
+        }
+
+        // every invocation reads the chunk total before the next chunk overwrites it
+        previousChunksTotal += sPartialSums[WORK_GROUP_SIZE - 1];
+        SharedMemorySync();
+    }
+}